@@ -1,26 +1,41 @@
 #define NDEBUG
 
 #include "bfs.h"
+#include "bfs_validation.h"
+#include "graph.h"
 #include "graph_builder.h"
+#include "graph_io.h"
+#include "compressed_graph.h"
+#include "graph_generators.h"
+#include "graph_reorder.h"
+#include "ms_bfs.h"
+#include "bidirectional_bfs.h"
 #include "parray.hpp"
 #include <chrono>
 #include <iostream>
 #include <vector>
 #include <functional>
+#include <type_traits>
 #include <array>
 #include <string>
+#include <limits>
+#include <utility>
+#include <algorithm>
 
-template <template <typename, typename ...> typename C, std::size_t DIM>
+/*
+D is the distance type, it is not deduced from bfs_fun, so lambdas can be passed directly
+*/
+template <template <typename, typename ...> typename C, typename Graph, typename D = int64_t>
 uint64_t measure(
-    uint64_t nodes_count, std::vector<std::vector<uint64_t>> const& edges, uint32_t reps,
-    std::function<C<int64_t>(uint64_t, uint64_t,  std::vector<std::vector<uint64_t>> const&)> const& bfs_fun)
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, uint32_t reps,
+    std::function<C<typename std::decay<D>::type>(uint64_t, uint64_t, Graph const&)> const& bfs_fun)
 {
     uint64_t sum = 0;
     for (uint32_t i = 0; i < reps; ++i)
     {
         std::cout << "Repetition " << i << std::endl;
         std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
-        bfs_fun(nodes_count, 0, edges);
+        bfs_fun(nodes_count, start_node, edges);
         std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
         sum += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
     }
@@ -37,51 +52,413 @@ std::string node_loop_type_to_string(NodeLoopType node_loop_type)
             return "non_range_cost";
         case NodeLoopType::Range:
             return "range";
+        case NodeLoopType::EdgeBalanced:
+            return "edge_balanced";
         default:
             return "error!";
     }
 }
 
-int main()
+/*
+Returns the time of the sequential BFS and the best time of the parallel one.
+Direction-optimizing BFS is measured only on symmetric graphs.
+*/
+template <typename Graph>
+std::pair<uint64_t, uint64_t> measure_all(
+    std::string const& graph_name, uint64_t nodes_count, Graph const& edges, uint32_t reps,
+    uint64_t start_node = 0, bool symmetric = true)
 {
-    assert(false && "disable assertions before banchmarking");
-    std::array<uint64_t, 3> dims = {500, 500, 500};
-    uint64_t nodes_count = calc_nodes_count(dims);
-    auto edges = build_graph(dims);
-    uint32_t reps = 5;
+    std::cout << "Graph representation: " << graph_name << ", memory " <<
+        graph_memory_bytes(edges) / (1024 * 1024) << " megabytes" << std::endl;
 
     std::cout << "Measuring sequential BFS" << std::endl;
-    uint64_t seq_res = measure<std::vector, 3>(nodes_count, edges, reps, bfs_sequential);
+    uint64_t seq_res = measure<std::vector, Graph>(nodes_count, start_node, edges, reps, bfs_sequential<Graph>);
     std::cout << "Elapsed " << seq_res << " milliseconds" << std::endl;
 
     std::vector<NodeLoopType> all_loop_types({
-        NodeLoopType::NonRange, NodeLoopType::NonRangeCost, NodeLoopType::Range
+        NodeLoopType::NonRange, NodeLoopType::NonRangeCost, NodeLoopType::Range, NodeLoopType::EdgeBalanced
     });
     std::vector<bool> all_bools({false, true});
-    
+    uint64_t best_cas_res = UINT64_MAX;
+
     for (NodeLoopType cur_loop_type : all_loop_types)
     {
         for (bool process_edges_in_parallel : all_bools)
         {
-            std::cout << "Measuring parallel + CAS, loop type = " << 
-                node_loop_type_to_string(cur_loop_type) << 
+            std::cout << "Measuring parallel + CAS, loop type = " <<
+                node_loop_type_to_string(cur_loop_type) <<
                 ", process edges in parallel = " << process_edges_in_parallel << std::endl;
 
-            uint64_t cas_res = measure<pasl::pctl::parray, 3>(
-                nodes_count, edges, reps, 
+            uint64_t cas_res = measure<pasl::pctl::parray, Graph>(
+                nodes_count, start_node, edges, reps,
                 [cur_loop_type, process_edges_in_parallel](
-                    uint64_t nodes_count, uint64_t start_node, 
-                    std::vector<std::vector<uint64_t>> const& edges)
+                    uint64_t nodes_count, uint64_t start_node, Graph const& edges)
                 {
                     return bfs_cas(
-                        nodes_count, start_node, edges, 
+                        nodes_count, start_node, edges,
                         cur_loop_type, process_edges_in_parallel
                     );
                 }
             );
             std::cout << "Elapsed " << cas_res << " milliseconds" << std::endl;
+            best_cas_res = std::min(best_cas_res, cas_res);
+        }
+    }
+
+    bfs_frontier frontier(nodes_count);
+    std::vector<VisitMarking> all_markings({VisitMarking::SeqCstCas, VisitMarking::TestAndCas});
+    for (VisitMarking marking : all_markings)
+    {
+        std::cout << "Measuring parallel + CAS with adaptive frontier, test before CAS = " <<
+            (marking == VisitMarking::TestAndCas) << std::endl;
+        uint64_t adaptive_res = measure<pasl::pctl::parray, Graph>(
+            nodes_count, start_node, edges, reps,
+            [&frontier, marking](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+            {
+                return bfs_cas_adaptive(nodes_count, start_node, edges, frontier, marking);
+            }
+        );
+        std::cout << "Elapsed " << adaptive_res << " milliseconds" << std::endl;
+        best_cas_res = std::min(best_cas_res, adaptive_res);
+    }
+
+    std::cout << "Measuring parallel with visited bitset and 32-bit distances" << std::endl;
+    uint64_t bitset_res = measure<pasl::pctl::parray, Graph, int32_t>(
+        nodes_count, start_node, edges, reps,
+        [&frontier](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+        {
+            return bfs_visited_bitset(nodes_count, start_node, edges, frontier);
+        }
+    );
+    std::cout << "Elapsed " << bitset_res << " milliseconds" << std::endl;
+    best_cas_res = std::min(best_cas_res, bitset_res);
+
+    std::cout << "Measuring parallel + CAS with per-worker frontier lists" << std::endl;
+    worker_frontier local_frontier;
+    uint64_t worker_res = measure<pasl::pctl::parray, Graph>(
+        nodes_count, start_node, edges, reps,
+        [&local_frontier](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+        {
+            return bfs_worker_buffers(nodes_count, start_node, edges, local_frontier);
+        }
+    );
+    std::cout << "Elapsed " << worker_res << " milliseconds" << std::endl;
+    best_cas_res = std::min(best_cas_res, worker_res);
+
+    std::cout << "Measuring parallel + CAS with parent output" << std::endl;
+    uint64_t parents_res = measure<pasl::pctl::parray, Graph>(
+        nodes_count, start_node, edges, reps,
+        [&frontier](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+        {
+            return bfs_cas_parents(nodes_count, start_node, edges, frontier);
+        }
+    );
+    std::cout << "Elapsed " << parents_res << " milliseconds" << std::endl;
+    best_cas_res = std::min(best_cas_res, parents_res);
+
+    pasl::pctl::parray<int64_t> parents = bfs_cas_parents(nodes_count, start_node, edges, frontier);
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    BfsValidationError error = validate_bfs_tree(nodes_count, start_node, edges, parents);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "BFS tree validated in " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds, " <<
+        (error == BfsValidationError::None ? "valid" : "INVALID") << std::endl;
+
+    if (symmetric)
+    {
+        std::cout << "Measuring direction-optimizing BFS" << std::endl;
+        uint64_t dir_opt_res = measure<pasl::pctl::parray, Graph>(
+            nodes_count, start_node, edges, reps,
+            [](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+            {
+                return bfs_direction_optimizing(nodes_count, start_node, edges);
+            }
+        );
+        std::cout << "Elapsed " << dir_opt_res << " milliseconds" << std::endl;
+        best_cas_res = std::min(best_cas_res, dir_opt_res);
+    }
+    return {seq_res, best_cas_res};
+}
+
+template <typename V>
+void measure_compressed(
+    std::string const& graph_name, csr_graph<V> const& edges, uint32_t reps,
+    uint64_t start_node = 0, bool symmetric = true)
+{
+    std::pair<uint64_t, uint64_t> csr_res = measure_all(
+        graph_name, edges.nodes_count(), edges, reps, start_node, symmetric
+    );
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    compressed_graph compressed = compress_graph(edges);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "Compressed in " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds, " <<
+        "compression ratio " << static_cast<double>(graph_memory_bytes(edges)) / graph_memory_bytes(compressed) <<
+        std::endl;
+
+    std::pair<uint64_t, uint64_t> compressed_res = measure_all(
+        "compressed", compressed.nodes_count(), compressed, reps, start_node, symmetric
+    );
+    std::cout << "Compressed / " << graph_name <<
+        " time: sequential " << static_cast<double>(compressed_res.first) / std::max<uint64_t>(csr_res.first, 1) <<
+        ", parallel " << static_cast<double>(compressed_res.second) / std::max<uint64_t>(csr_res.second, 1) <<
+        std::endl;
+}
+
+/*
+Generated graphs may have isolated nodes, so BFS starts from the node of the maximal degree
+*/
+template <typename V>
+uint64_t max_degree_node(csr_graph<V> const& edges)
+{
+    uint64_t result = 0;
+    for (uint64_t node = 0; node < edges.nodes_count(); ++node)
+    {
+        if (edges.degree(node) > edges.degree(result))
+        {
+            result = node;
         }
     }
+    return result;
+}
+
+std::string vertex_order_to_string(VertexOrder order)
+{
+    switch (order)
+    {
+        case VertexOrder::Degree:
+            return "degree order";
+        case VertexOrder::Bfs:
+            return "BFS order";
+        case VertexOrder::ReverseCuthillMcKee:
+            return "reverse Cuthill-McKee order";
+        case VertexOrder::GorderLite:
+            return "Gorder-lite order";
+        default:
+            return "error!";
+    }
+}
+
+template <typename V>
+void measure_orders(std::string const& graph_name, csr_graph<V> const& edges, uint32_t reps, uint64_t start_node)
+{
+    measure_all(graph_name + ", original order", edges.nodes_count(), edges, reps, start_node);
+
+    std::vector<VertexOrder> all_orders({
+        VertexOrder::Degree, VertexOrder::Bfs, VertexOrder::ReverseCuthillMcKee, VertexOrder::GorderLite
+    });
+    for (VertexOrder order : all_orders)
+    {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        reordered_graph<V> reordered = reorder_graph(edges, order, start_node);
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << "Reordered in " <<
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds" << std::endl;
+        measure_all(
+            graph_name + ", " + vertex_order_to_string(order), reordered.graph.nodes_count(), reordered.graph, reps,
+            reordered.old_to_new[start_node]
+        );
+    }
+}
+
+/*
+Compares one multi-source BFS with separate traversals from every source
+*/
+template <typename Graph>
+void measure_multi_source(uint64_t nodes_count, Graph const& edges, uint64_t sources_count)
+{
+    std::vector<uint64_t> sources;
+    for (uint64_t i = 0; i < sources_count; ++i)
+    {
+        sources.push_back(random_hash(42, i) % nodes_count);
+    }
+    std::cout << "Measuring " << sources_count << " sources" << std::endl;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    bfs_frontier frontier(nodes_count);
+    for (uint64_t source : sources)
+    {
+        bfs_cas_adaptive(nodes_count, source, edges, frontier, VisitMarking::TestAndCas);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "Separate traversals elapsed " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds" << std::endl;
+
+    begin = std::chrono::steady_clock::now();
+    multi_source_bfs(nodes_count, sources, edges);
+    end = std::chrono::steady_clock::now();
+    std::cout << "Multi-source BFS elapsed " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds" << std::endl;
+}
+
+/*
+Compares point-to-point queries answered by bidirectional BFS with full traversals from the start node
+*/
+template <typename Graph>
+void measure_point_to_point(uint64_t nodes_count, Graph const& edges, uint64_t queries_count)
+{
+    std::cout << "Measuring " << queries_count << " point-to-point queries" << std::endl;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    bfs_frontier frontier(nodes_count);
+    for (uint64_t query = 0; query < queries_count; ++query)
+    {
+        bfs_cas_adaptive(nodes_count, random_hash(42, query, 0) % nodes_count, edges, frontier, VisitMarking::TestAndCas);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "Full traversals elapsed " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds" << std::endl;
+
+    begin = std::chrono::steady_clock::now();
+    for (uint64_t query = 0; query < queries_count; ++query)
+    {
+        bfs_bidirectional(
+            nodes_count, random_hash(42, query, 0) % nodes_count, random_hash(42, query, 1) % nodes_count, edges
+        );
+    }
+    end = std::chrono::steady_clock::now();
+    std::cout << "Bidirectional BFS elapsed " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds" << std::endl;
+}
+
+void measure_generated(uint32_t scale, uint32_t reps)
+{
+    uint64_t seed = 42;
+    {
+        csr_graph<uint32_t> edges = generate_rmat_graph<uint32_t>(scale, 16, seed);
+        measure_orders("R-MAT, scale " + std::to_string(scale), edges, reps, max_degree_node(edges));
+        measure_point_to_point(edges.nodes_count(), edges, 100);
+    }
+    {
+        csr_graph<uint32_t> edges = generate_uniform_graph<uint32_t>(UINT64_C(1) << scale, 32, seed);
+        measure_orders("uniform random", edges, reps, max_degree_node(edges));
+    }
+    {
+        csr_graph<uint32_t> edges = generate_regular_graph<uint32_t>(UINT64_C(1) << scale, 32, seed);
+        measure_all("random regular", edges.nodes_count(), edges, reps, max_degree_node(edges));
+        for (uint64_t sources_count : {64, 512})
+        {
+            measure_multi_source(edges.nodes_count(), edges, sources_count);
+        }
+    }
+}
+
+void print_load_time(std::chrono::steady_clock::time_point begin)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "Loaded in " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds" << std::endl;
+}
+
+/*
+Loads a graph from a file and builds CSR with 32-bit vertex ids if they fit
+*/
+void measure_file(std::string const& format, std::string const& path, bool symmetrize, uint32_t reps)
+{
+    csr_build_options options;
+    options.symmetrize = symmetrize;
+    options.remove_duplicates = true;
+    options.remove_self_loops = true;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    if (format == "csr")
+    {
+        if (csr_binary_vertex_size(path) == sizeof(uint32_t))
+        {
+            csr_graph<uint32_t> edges = load_csr_binary<uint32_t>(path);
+            print_load_time(begin);
+            measure_compressed("CSR, 32-bit vertex ids", edges, reps, 0, symmetrize);
+        }
+        else
+        {
+            csr_graph<uint64_t> edges = load_csr_binary<uint64_t>(path);
+            print_load_time(begin);
+            measure_compressed("CSR, 64-bit vertex ids", edges, reps, 0, symmetrize);
+        }
+        return;
+    }
+
+    edge_list input_edges = [&format, &path, &options]()
+    {
+        if (format == "mtx")
+        {
+            bool symmetric = false;
+            edge_list result = read_matrix_market(path, symmetric);
+            options.symmetrize = options.symmetrize || symmetric;
+            return result;
+        }
+        return read_edge_list(path);
+    }();
+    if (input_edges.nodes_count <= std::numeric_limits<uint32_t>::max())
+    {
+        csr_graph<uint32_t> edges = edge_list_to_csr<uint32_t>(input_edges, options);
+        print_load_time(begin);
+        measure_compressed("CSR, 32-bit vertex ids", edges, reps, 0, options.symmetrize);
+    }
+    else
+    {
+        csr_graph<uint64_t> edges = edge_list_to_csr<uint64_t>(input_edges, options);
+        print_load_time(begin);
+        measure_compressed("CSR, 64-bit vertex ids", edges, reps, 0, options.symmetrize);
+    }
+}
+
+/*
+Usage: bench_bfs.out runs on the 500 x 500 x 500 cube and on generated graphs of scale 22,
+bench_bfs.out generated <scale> runs only on generated graphs with 2^scale nodes,
+bench_bfs.out <edges|mtx|csr> <path> [symmetrize] runs on a graph loaded from the file
+*/
+int main(int argc, char** argv)
+{
+    assert(false && "disable assertions before banchmarking");
+    uint32_t reps = 5;
+
+    if (argc >= 3 && std::string(argv[1]) == "generated")
+    {
+        measure_generated(static_cast<uint32_t>(std::stoul(argv[2])), reps);
+        return 0;
+    }
+    if (argc >= 3)
+    {
+        std::string format = argv[1];
+        if (format != "edges" && format != "mtx" && format != "csr")
+        {
+            std::cerr << "Unknown graph format " << format << ", expected generated, edges, mtx or csr" << std::endl;
+            return 1;
+        }
+        bool symmetrize = (argc >= 4 && std::string(argv[3]) == "symmetrize");
+        measure_file(format, argv[2], symmetrize, reps);
+        return 0;
+    }
+
+    std::array<uint64_t, 3> dims = {500, 500, 500};
+    uint64_t nodes_count = calc_nodes_count(dims);
+
+    {
+        adjacency_list edges = build_graph(dims);
+        measure_all("adjacency list", nodes_count, edges, reps);
+    }
+    {
+        csr_graph<uint64_t> edges = build_csr_graph<uint64_t>(dims);
+        measure_all("CSR, 64-bit vertex ids", nodes_count, edges, reps);
+    }
+    {
+        csr_graph<uint32_t> edges = build_csr_graph<uint32_t>(dims);
+        measure_compressed("CSR, 32-bit vertex ids", edges, reps);
+    }
+    {
+        grid_graph<3> edges(dims);
+        measure_all("implicit grid", nodes_count, edges, reps);
+    }
+    {
+        csr_graph<uint32_t> edges = build_csr_graph<uint32_t>(dims, GridLayout::Morton);
+        measure_all("CSR, 32-bit vertex ids, Morton layout", nodes_count, edges, reps);
+    }
+    {
+        grid_graph<3> edges(dims, GridLayout::Morton);
+        measure_all("implicit grid, Morton layout", nodes_count, edges, reps);
+    }
+    measure_generated(22, reps);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,84 @@
+#define NDEBUG
+
+#include "connected_components.h"
+#include "graph.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include "parray.hpp"
+#include <chrono>
+#include <iostream>
+#include <array>
+#include <string>
+#include <algorithm>
+
+template <typename F>
+uint64_t measure(uint32_t reps, F const& components_fun)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < reps; ++i)
+    {
+        std::cout << "Repetition " << i << std::endl;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        components_fun();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        sum += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+    }
+    return sum / reps;
+}
+
+template <typename Graph>
+void measure_all(std::string const& graph_name, uint64_t nodes_count, Graph const& edges, uint32_t reps)
+{
+    std::cout << "Measuring " << graph_name << std::endl;
+    connected_components components = connected_components_union_find(nodes_count, edges);
+    std::cout << components.sizes.size() << " components, the largest has " <<
+        *std::max_element(components.sizes.begin(), components.sizes.end()) << " nodes" << std::endl;
+
+    std::cout << "Measuring sequential" << std::endl;
+    uint64_t seq_res = measure(
+        reps,
+        [nodes_count, &edges]()
+        {
+            connected_components_sequential(nodes_count, edges);
+        }
+    );
+    std::cout << "Elapsed " << seq_res << " milliseconds" << std::endl;
+
+    std::cout << "Measuring parallel union-find" << std::endl;
+    uint64_t par_res = measure(
+        reps,
+        [nodes_count, &edges]()
+        {
+            connected_components_union_find(nodes_count, edges);
+        }
+    );
+    std::cout << "Elapsed " << par_res << " milliseconds" << std::endl;
+    std::cout << "Parallel speedup " << static_cast<double>(seq_res) / std::max<uint64_t>(par_res, 1) << std::endl;
+}
+
+int main()
+{
+    assert(false && "disable assertions before banchmarking");
+    uint32_t reps = 5;
+    uint64_t seed = 42;
+
+    {
+        std::array<uint64_t, 3> dims = {500, 500, 500};
+        csr_graph<uint32_t> edges = build_csr_graph<uint32_t>(dims);
+        measure_all("cube, csr, 32-bit vertex ids", edges.nodes_count(), edges, reps);
+    }
+    {
+        csr_graph<uint32_t> edges = generate_rmat_graph<uint32_t>(22, 16, seed);
+        measure_all("R-MAT, scale 22", edges.nodes_count(), edges, reps);
+    }
+    {
+        csr_graph<uint32_t> edges = generate_uniform_graph<uint32_t>(UINT64_C(1) << 22, 32, seed);
+        measure_all("uniform random, average degree 32", edges.nodes_count(), edges, reps);
+    }
+    {
+        // below the giant component threshold there are many components of all sizes
+        csr_graph<uint32_t> edges = generate_uniform_graph<uint32_t>(UINT64_C(1) << 22, 1, seed);
+        measure_all("uniform random, average degree 1", edges.nodes_count(), edges, reps);
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "sort.h"
+#include "scan.h"
+#include "raw_array.h"
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <functional>
+
+uint64_t measure(uint32_t reps, std::function<void()> const& fun)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < reps; ++i)
+    {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        fun();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        sum += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+    }
+    return sum / reps;
+}
+
+raw_array<int32_t> read_file(std::string const& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    uint32_t sz = static_cast<uint32_t>(in.tellg() / sizeof(int32_t));
+    in.seekg(0);
+    raw_array<int32_t> result(sz);
+    in.read(reinterpret_cast<char*>(result.get_raw_ptr()), static_cast<std::streamsize>(sz) * sizeof(int32_t));
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    std::string path = "bench_mmap_input.bin";
+    if (argc > 1)
+    {
+        path = argv[1];
+    }
+    uint32_t sz = 100'000'000;
+    uint32_t reps = 5;
+    uint32_t blocks_count = 160;
+    uint32_t seq_block_size = 1'000'000;
+
+    if (!std::ifstream(path).good())
+    {
+        std::cout << "Generating " << path << std::endl;
+        std::default_random_engine generator(time(nullptr));
+        std::uniform_int_distribution<int32_t> elements_distribution(-1000, 1000);
+        raw_array<int32_t> input(sz);
+        for (uint32_t j = 0; j < sz; ++j)
+        {
+            input[j] = elements_distribution(generator);
+        }
+        input.write_to_file(path);
+    }
+
+    uint64_t res = measure(reps, [&path]() { read_file(path); });
+    std::cout << "Loading with read, elapsed " << res << " milliseconds" << std::endl;
+
+    res = measure(reps, [&path]() { raw_array<int32_t>::map_file<MapMode::ReadOnly>(path); });
+    std::cout << "Mapping with populate, elapsed " << res << " milliseconds" << std::endl;
+
+    res = measure(reps, [&path]() { raw_array<int32_t>::map_file<MapMode::ReadOnly>(path, false); });
+    std::cout << "Mapping without populate, elapsed " << res << " milliseconds" << std::endl;
+
+    raw_array<int32_t> loaded = read_file(path);
+    res = measure(reps, [&loaded, blocks_count]() { scan_exclusive_blocked(loaded, blocks_count); });
+    std::cout << "Scan, read input, elapsed " << res << " milliseconds" << std::endl;
+
+    raw_array<int32_t const> mapped = raw_array<int32_t>::map_file<MapMode::ReadOnly>(path);
+    res = measure(reps, [&mapped, blocks_count]() { scan_exclusive_blocked(mapped, blocks_count); });
+    std::cout << "Scan, mapped input, elapsed " << res << " milliseconds" << std::endl;
+
+    res = measure(
+        reps,
+        [&path, seq_block_size]()
+        {
+            raw_array<int32_t> arr = read_file(path);
+            sort_parallel_no_filters(arr, seq_block_size);
+        }
+    );
+    std::cout << "Load with read and sort, elapsed " << res << " milliseconds" << std::endl;
+
+    res = measure(
+        reps,
+        [&path, seq_block_size]()
+        {
+            raw_array<int32_t> arr = raw_array<int32_t>::map_file<MapMode::CopyOnWrite>(path);
+            sort_parallel_no_filters(arr, seq_block_size);
+        }
+    );
+    std::cout << "Map copy-on-write and sort, elapsed " << res << " milliseconds" << std::endl;
+
+    std::string sorted_path = path + ".sorted";
+    res = measure(
+        reps,
+        [&path, &sorted_path, seq_block_size]()
+        {
+            raw_array<int32_t> arr = raw_array<int32_t>::map_file<MapMode::CopyOnWrite>(path);
+            sort_parallel_no_filters(arr, seq_block_size);
+            arr.write_to_file(sorted_path);
+        }
+    );
+    std::cout << "Map copy-on-write, sort and write back, elapsed " << res << " milliseconds" << std::endl;
+    return 0;
+}
@@ -0,0 +1,89 @@
+#define NDEBUG
+
+#include "pagerank.h"
+#include "graph.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include "parray.hpp"
+#include <chrono>
+#include <iostream>
+#include <array>
+#include <string>
+#include <algorithm>
+
+/*
+Returns iterations per second, averaged over repetitions
+*/
+template <typename F>
+double measure(uint32_t reps, F const& pagerank_fun)
+{
+    uint64_t iterations = 0;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < reps; ++i)
+    {
+        std::cout << "Repetition " << i << std::endl;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        iterations += pagerank_fun().iterations;
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        sum += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+    }
+    return 1000.0 * iterations / std::max<uint64_t>(sum, 1);
+}
+
+template <typename V>
+void measure_all(std::string const& graph_name, csr_graph<V> const& graph, uint32_t reps)
+{
+    std::cout << "Measuring " << graph_name << std::endl;
+    pagerank_options options;
+    options.max_iterations = 20;
+
+    std::cout << "Measuring sequential PageRank" << std::endl;
+    double seq_res = measure(
+        reps,
+        [&graph, &options]()
+        {
+            return pagerank_sequential(graph, options);
+        }
+    );
+    std::cout << seq_res << " iterations per second" << std::endl;
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    csr_graph<V> in_graph = transpose_graph(graph, csr_build_options());
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "Transposed in " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << " milliseconds" << std::endl;
+
+    for (bool delta_updates : {false, true})
+    {
+        options.delta_updates = delta_updates;
+        std::cout << "Measuring pull PageRank, " << (delta_updates ? "delta" : "full") << " updates" << std::endl;
+        double par_res = measure(
+            reps,
+            [&graph, &in_graph, &options]()
+            {
+                return pagerank_pull(graph, in_graph, options);
+            }
+        );
+        std::cout << par_res << " iterations per second" << std::endl;
+        std::cout << "Parallel speedup " << par_res / seq_res << std::endl;
+    }
+}
+
+int main()
+{
+    assert(false && "disable assertions before banchmarking");
+    uint32_t reps = 5;
+    uint64_t seed = 42;
+
+    {
+        std::array<uint64_t, 3> dims = {500, 500, 500};
+        measure_all("cube", build_csr_graph<uint32_t>(dims), reps);
+    }
+    {
+        measure_all("R-MAT, scale 24", generate_rmat_graph<uint32_t>(24, 16, seed), reps);
+    }
+    {
+        measure_all("uniform random", generate_uniform_graph<uint32_t>(UINT64_C(1) << 24, 16, seed), reps);
+    }
+    return 0;
+}
@@ -7,18 +7,12 @@
 #include <functional>
 
 template <template <typename, typename ...> typename C>
-uint64_t measure(
-    std::default_random_engine& generator, std::uniform_int_distribution<int32_t>& elements_distribution,
-    uint32_t sz, uint32_t reps, std::function<void(C<int32_t>&)> sorter)
+uint64_t measure(C<int32_t> const& input, uint32_t reps, std::function<void(C<int32_t>&)> sorter)
 {
     uint64_t sum = 0;
     for (uint32_t i = 0; i < reps; ++i)
     {
-        C<int32_t> arr(sz);
-        for (uint32_t j = 0; j < sz; ++j)
-        {
-            arr[j] = elements_distribution(generator);
-        }
+        C<int32_t> arr(input);
 
         std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
         sorter(arr);
@@ -35,8 +29,15 @@ int main()
     uint32_t sz = 100'000'000;
     uint32_t reps = 5;
 
+    raw_array<int32_t> input(sz);
+    for (uint32_t j = 0; j < sz; ++j)
+    {
+        input[j] = elements_distribution(generator);
+    }
+    std::vector<int32_t> input_vector(input.begin(), input.end());
+
     uint64_t res = measure<raw_array>(
-        generator, elements_distribution, sz, reps,
+        input, reps,
         [](raw_array<int32_t>& arr)
         {
             sort_sequential(arr);
@@ -49,7 +50,7 @@ int main()
     for (uint32_t seq_block_size : block_sizes)
     {
         uint64_t res = measure<raw_array>(
-            generator, elements_distribution, sz, reps,
+            input, reps,
             [seq_block_size](raw_array<int32_t>& arr)
             {
                 sort_parallel(arr, seq_block_size);
@@ -59,7 +60,7 @@ int main()
             " seq block size, elapsed " << res << " milliseconds" << std::endl;
 
         res = measure<std::vector>(
-            generator, elements_distribution, sz, reps,
+            input_vector, reps,
             [seq_block_size](std::vector<int32_t>& arr)
             {
                 sort_parallel_filter_seq(arr, seq_block_size);
@@ -69,7 +70,7 @@ int main()
             " seq block size, elapsed " << res << " milliseconds" << std::endl;
 
         res = measure<std::vector>(
-            generator, elements_distribution, sz, reps,
+            input_vector, reps,
             [seq_block_size](std::vector<int32_t>& arr)
             {
                 sort_parallel_no_filters(arr, seq_block_size);
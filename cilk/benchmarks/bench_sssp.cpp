@@ -0,0 +1,85 @@
+#define NDEBUG
+
+#include "sssp.h"
+#include "weighted_graph.h"
+#include "graph.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include "parray.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+#include <algorithm>
+
+template <typename F>
+uint64_t measure(uint32_t reps, F const& sssp_fun)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < reps; ++i)
+    {
+        std::cout << "Repetition " << i << std::endl;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        sssp_fun();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        sum += std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+    }
+    return sum / reps;
+}
+
+template <typename V, typename W>
+void measure_all(
+    std::string const& graph_name, weighted_csr_graph<V, W> const& graph, std::vector<int64_t> const& deltas,
+    uint32_t reps)
+{
+    std::cout << "Measuring " << graph_name << std::endl;
+    uint64_t nodes_count = graph.nodes_count();
+
+    std::cout << "Measuring sequential Dijkstra" << std::endl;
+    uint64_t seq_res = measure(
+        reps,
+        [nodes_count, &graph]()
+        {
+            sssp_dijkstra(nodes_count, 0, graph);
+        }
+    );
+    std::cout << "Elapsed " << seq_res << " milliseconds" << std::endl;
+
+    for (int64_t delta : deltas)
+    {
+        std::cout << "Measuring delta-stepping, delta = " << delta << std::endl;
+        uint64_t par_res = measure(
+            reps,
+            [nodes_count, &graph, delta]()
+            {
+                sssp_delta_stepping(nodes_count, 0, graph, delta);
+            }
+        );
+        std::cout << "Elapsed " << par_res << " milliseconds" << std::endl;
+        std::cout << "Parallel speedup " << static_cast<double>(seq_res) / std::max<uint64_t>(par_res, 1) << std::endl;
+    }
+}
+
+int main()
+{
+    assert(false && "disable assertions before banchmarking");
+    uint32_t reps = 5;
+    uint64_t seed = 42;
+    uint32_t max_weight = 255;
+    std::vector<int64_t> deltas({1, 32, 128, 255, 1024});
+
+    {
+        std::array<uint64_t, 3> dims = {300, 300, 300};
+        measure_all("weighted cube", build_weighted_grid_graph<uint32_t, uint32_t>(dims, max_weight, seed), deltas, reps);
+    }
+    {
+        csr_graph<uint32_t> edges = generate_rmat_graph<uint32_t>(22, 16, seed);
+        measure_all("weighted R-MAT, scale 22", add_random_weights(std::move(edges), max_weight, seed), deltas, reps);
+    }
+    {
+        csr_graph<uint32_t> edges = generate_uniform_graph<uint32_t>(UINT64_C(1) << 22, 16, seed);
+        measure_all("weighted uniform random", add_random_weights(std::move(edges), max_weight, seed), deltas, reps);
+    }
+    return 0;
+}
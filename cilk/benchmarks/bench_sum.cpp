@@ -23,20 +23,12 @@ int64_t calc_sum_sequential(std::vector<int64_t> const& arr)
 }
 
 template <template <typename, typename ...> typename C>
-uint64_t measure(
-    std::default_random_engine& generator, std::uniform_int_distribution<int64_t>& elements_distribution,
-    uint32_t reps, uint64_t size, std::function<int64_t(C<int64_t> const&)> const& sum_fun)
+uint64_t measure(C<int64_t> const& arr, uint32_t reps, std::function<int64_t(C<int64_t> const&)> const& sum_fun)
 {
     uint64_t sum = 0;
     for (uint32_t i = 0; i < reps; ++i)
     {
         std::cout << "Repetition#" << i << std::endl;
-        C<int64_t> arr(size);
-        for (uint64_t j = 0; j < size; ++j)
-        {
-            arr[j] = elements_distribution(generator);
-        }
-
         std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
         sum_fun(arr);
         std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
@@ -52,12 +44,25 @@ int main()
     uint32_t sz = 100'000'000;
     uint32_t reps = 5;
 
+    std::vector<int64_t> input(sz);
+    for (uint32_t j = 0; j < sz; ++j)
+    {
+        input[j] = elements_distribution(generator);
+    }
+    pasl::pctl::parray<int64_t> input_parray(
+        input.size(),
+        [&input](long idx)
+        {
+            return input[idx];
+        }
+    );
+
     std::cout << "Measuring sequential sum" << std::endl;
-    uint64_t seq_res = measure<std::vector>(generator, elements_distribution, reps, sz, calc_sum_sequential);
+    uint64_t seq_res = measure<std::vector>(input, reps, calc_sum_sequential);
     std::cout << "Sequential, elapsed " << seq_res << " milliseconds" << std::endl;
 
     std::cout << "Measuring parallel sum" << std::endl;
-    uint64_t par_res = measure<pasl::pctl::parray>(generator, elements_distribution, reps, sz, calc_sum_parallel);
+    uint64_t par_res = measure<pasl::pctl::parray>(input_parray, reps, calc_sum_parallel);
     std::cout << "Parallel, elapsed " << par_res << " milliseconds" << std::endl;
 
     return 0;
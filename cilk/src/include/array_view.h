@@ -0,0 +1,100 @@
+#pragma once
+
+#include "raw_array.h"
+#include <cstdint>
+#include <cassert>
+#include <type_traits>
+#include <vector>
+
+/*
+Non-owning view of a contiguous range of elements. Copying a view never copies the elements,
+array_view<T const> gives read-only access.
+*/
+
+template <typename T>
+struct array_view
+{
+public:
+    using value_type = std::remove_const_t<T>;
+
+    array_view(T* ptr, uint32_t view_size) : _ptr(ptr),
+                                             _size(view_size)
+    {
+    }
+
+    array_view(raw_array<value_type>& arr) : _ptr(arr.get_raw_ptr()),
+                                             _size(arr.size())
+    {
+    }
+
+    array_view(raw_array<value_type> const& arr) : _ptr(arr.get_raw_ptr()),
+                                                   _size(arr.size())
+    {
+    }
+
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_same<U, T>::value && std::is_const<U>::value>
+    >
+    array_view(raw_array<U> const& arr) : _ptr(arr.get_raw_ptr()),
+                                          _size(arr.size())
+    {
+    }
+
+    array_view(std::vector<value_type>& vec) : _ptr(vec.data()),
+                                               _size(static_cast<uint32_t>(vec.size()))
+    {
+    }
+
+    array_view(std::vector<value_type> const& vec) : _ptr(vec.data()),
+                                                     _size(static_cast<uint32_t>(vec.size()))
+    {
+    }
+
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_same<U const, T>::value && !std::is_same<U, T>::value>
+    >
+    array_view(array_view<U> const& other) : _ptr(other.get_raw_ptr()),
+                                             _size(other.size())
+    {
+    }
+
+    /*
+    View of elements with indexes [left, right)
+    */
+    array_view<T> slice(uint32_t left, uint32_t right) const
+    {
+        assert(left <= right && right <= _size);
+        return array_view<T>(_ptr + left, right - left);
+    }
+
+    T* get_raw_ptr() const
+    {
+        return _ptr;
+    }
+
+    T* begin() const
+    {
+        return _ptr;
+    }
+
+    T* end() const
+    {
+        return _ptr + _size;
+    }
+
+    T& operator[](uint32_t idx) const
+    {
+        assert(idx < _size);
+        return *(_ptr + idx);
+    }
+
+    uint32_t size() const
+    {
+        return _size;
+    }
+private:
+    T*       _ptr;
+    uint32_t _size;
+};
@@ -2,19 +2,23 @@
 
 #include "parray.hpp"
 #include "datapar.hpp"
+#include "graph.h"
+#include "frontier.h"
 #include <vector>
 #include <cstdint>
 #include <queue>
 #include <atomic>
 #include <functional>
+#include <algorithm>
+#include <tuple>
+#include <utility>
 
 /*
 Sequential BFS
 */
 
-inline std::vector<int64_t> bfs_sequential(
-    uint64_t nodes_count, uint64_t start_node,
-    std::vector<std::vector<uint64_t>> const& edges)
+template <typename Graph>
+std::vector<int64_t> bfs_sequential(uint64_t nodes_count, uint64_t start_node, Graph const& edges)
 {
     assert(0 <= start_node && start_node < nodes_count);
     std::vector<int64_t> result(nodes_count, -1);
@@ -30,114 +34,282 @@ inline std::vector<int64_t> bfs_sequential(
         assert(0 <= from_node && from_node < nodes_count);
         assert(result[from_node] >= 0);
 
-        for (uint64_t to_node : edges[from_node])
-        {
-            if (result[to_node] == -1)
-            {
-                result[to_node] = result[from_node] + 1;
-                q.push(to_node);
-            }
-            else
+        for_each_neighbor(
+            edges, from_node,
+            [&result, &q, from_node](uint64_t to_node)
             {
-                assert(result[to_node] >= 0);
+                if (result[to_node] == -1)
+                {
+                    result[to_node] = result[from_node] + 1;
+                    q.push(to_node);
+                }
+                else
+                {
+                    assert(result[to_node] >= 0);
+                }
             }
-        }
+        );
     }
 
     return result;
 }
 
+/*
+EdgeBalanced splits the edges of the frontier, not its nodes, into pieces of equal size,
+so a piece may start and end in the middle of a list: hubs are shared by several tasks without nested parallelism
+and process_edges_in_parallel is ignored. Edges are split into blocks of EDGE_BLOCK_SIZE, a task finds its first node
+by one binary search and enumerates every list it touches by one for_each_neighbor_range call.
+*/
 enum struct NodeLoopType 
 { 
     NonRange, 
     NonRangeCost, 
-    Range 
+    Range,
+    EdgeBalanced
 };
 
+uint64_t const EDGE_BLOCK_SIZE = 256;
+
 /*
-Parallel-CAS BFS
+Generic top-down step over a sparse frontier: visit(from_node, to_node, edge_idx) is called for every edge
+of the frontier, where edge_idx is the index of the edge in the list of from_node. Nodes, for which it returned true,
+form the new frontier, so visit must return true at most once for every node.
+Every edge gets its own cell, which is found by a scan of degrees, and empty cells are filtered out.
+loop_type chooses how the frontier is split into tasks, process_edges_in_parallel additionally splits
+the lists of single nodes: into single edges, or into blocks of EDGE_BLOCK_SIZE edges for graphs
+without indexed neighbors (see has_indexed_neighbors).
 */
 
-inline uint64_t get_node_size_cas(
-    pasl::pctl::parray<int64_t> const& cur_frontier, 
-    pasl::pctl::parray<int64_t> const& result,
-    std::vector<std::vector<uint64_t>> const& edges,
-    uint64_t node_idx)
-{
-    assert(cur_frontier[node_idx] >= 0);
-    uint64_t cur_node = static_cast<uint64_t>(cur_frontier[node_idx]);
-    assert(__atomic_load_n(&result[cur_node], __ATOMIC_SEQ_CST) >= 0);
-    return static_cast<uint64_t>(edges[cur_node].size());
-}
-
-inline void process_single_edge(
-    pasl::pctl::parray<int64_t>& result,
-    pasl::pctl::parray<int64_t>& new_frontier,
-    std::vector<uint64_t> const& to_nodes,
-    uint64_t start_idx, uint64_t from_node, uint64_t edge_idx)
+template <typename Graph, typename Visit>
+void expand_node(
+    Graph const& edges, pasl::pctl::parray<int64_t> const& frontier, Visit const& visit,
+    pasl::pctl::parray<uint64_t> const& offsets, pasl::pctl::parray<int64_t>& new_frontier,
+    uint64_t node_idx, bool process_edges_in_parallel)
 {
-    assert(new_frontier[start_idx + edge_idx] == -1);
-    uint64_t to_node = to_nodes[edge_idx];
-    int64_t expected_result = -1;
-    int64_t new_result = __atomic_load_n(&result[from_node], __ATOMIC_SEQ_CST) + 1;
-    bool cas_result = __atomic_compare_exchange_n(
-        &result[to_node], &expected_result, new_result,
-        false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST
-    );
-    if (cas_result)
+    assert(frontier[node_idx] >= 0);
+    uint64_t from_node = static_cast<uint64_t>(frontier[node_idx]);
+    uint64_t first_edge = offsets[node_idx];
+    uint64_t degree = offsets[node_idx + 1] - first_edge;
+    if constexpr (has_indexed_neighbors<Graph>::value)
     {
-        assert(expected_result == -1);
-        new_frontier[start_idx + edge_idx] = to_node;
+        if (process_edges_in_parallel)
+        {
+            pasl::pctl::parallel_for(
+                static_cast<uint64_t>(0), degree,
+                [&edges, &visit, &new_frontier, from_node, first_edge](uint64_t edge_idx)
+                {
+                    uint64_t to_node = node_neighbor(edges, from_node, edge_idx);
+                    if (visit(from_node, to_node, edge_idx))
+                    {
+                        new_frontier[first_edge + edge_idx] = static_cast<int64_t>(to_node);
+                    }
+                }
+            );
+            return;
+        }
     }
-    else
+    if (process_edges_in_parallel)
     {
-        assert(expected_result >= 0);
+        // blocks of the list, so graphs with sequential decoding skip a prefix once per block
+        pasl::pctl::parallel_for(
+            static_cast<uint64_t>(0), (degree + EDGE_BLOCK_SIZE - 1) / EDGE_BLOCK_SIZE,
+            [&edges, &visit, &new_frontier, from_node, first_edge, degree](uint64_t block_idx)
+            {
+                uint64_t edge_idx = block_idx * EDGE_BLOCK_SIZE;
+                for_each_neighbor_range(
+                    edges, from_node, edge_idx, std::min(degree, edge_idx + EDGE_BLOCK_SIZE),
+                    [&visit, &new_frontier, from_node, first_edge, &edge_idx](uint64_t to_node)
+                    {
+                        if (visit(from_node, to_node, edge_idx))
+                        {
+                            new_frontier[first_edge + edge_idx] = static_cast<int64_t>(to_node);
+                        }
+                        ++edge_idx;
+                    }
+                );
+            }
+        );
+        return;
     }
+    uint64_t edge_idx = 0;
+    for_each_neighbor(
+        edges, from_node,
+        [&visit, &new_frontier, from_node, first_edge, &edge_idx](uint64_t to_node)
+        {
+            if (visit(from_node, to_node, edge_idx))
+            {
+                new_frontier[first_edge + edge_idx] = static_cast<int64_t>(to_node);
+            }
+            ++edge_idx;
+        }
+    );
+    assert(first_edge + edge_idx == offsets[node_idx + 1]);
 }
 
-inline void process_single_node_cas(
-    std::vector<std::vector<uint64_t>> const& edges,
-    pasl::pctl::parray<int64_t> const& cur_frontier,
-    pasl::pctl::parray<int64_t>& result,
-    pasl::pctl::parray<int64_t>& new_frontier,
-    pasl::pctl::parray<uint64_t> const& pref_sizes,
-    uint64_t node_idx, bool process_edges_in_parallel)
+/*
+Edges [left, right) of the frontier in the order of offsets. The first node is found by a binary search,
+nodes without edges are skipped.
+*/
+template <typename Graph, typename Visit>
+void expand_edge_range(
+    Graph const& edges, pasl::pctl::parray<int64_t> const& frontier, Visit const& visit,
+    pasl::pctl::parray<uint64_t> const& offsets, pasl::pctl::parray<int64_t>& new_frontier,
+    uint64_t left, uint64_t right)
 {
-    assert(cur_frontier[node_idx] >= 0);
-    uint64_t from_node = cur_frontier[node_idx];
-    assert(__atomic_load_n(&result[from_node], __ATOMIC_SEQ_CST) >= 0);
-    uint64_t start_idx = pref_sizes[node_idx];
-
-    std::vector<uint64_t> const& to_nodes = edges[from_node];
-    if (process_edges_in_parallel)
+    uint64_t node_idx = std::upper_bound(offsets.begin(), offsets.end(), left) - offsets.begin() - 1;
+    uint64_t global_edge_idx = left;
+    while (global_edge_idx < right)
     {
-        pasl::pctl::parallel_for(
-            static_cast<uint64_t>(0), static_cast<uint64_t>(to_nodes.size()),
-            [&result, &new_frontier, &to_nodes, start_idx, from_node](uint64_t edge_idx)
+        assert(node_idx < static_cast<uint64_t>(frontier.size()));
+        uint64_t from_node = static_cast<uint64_t>(frontier[node_idx]);
+        uint64_t first_edge = offsets[node_idx];
+        uint64_t end_idx = std::min(right, offsets[node_idx + 1]);
+        uint64_t edge_idx = global_edge_idx - first_edge;
+        for_each_neighbor_range(
+            edges, from_node, edge_idx, end_idx - first_edge,
+            [&visit, &new_frontier, from_node, first_edge, &edge_idx](uint64_t to_node)
             {
-                process_single_edge(
-                    result, new_frontier, to_nodes, 
-                    start_idx, from_node, edge_idx
-                );
+                if (visit(from_node, to_node, edge_idx))
+                {
+                    new_frontier[first_edge + edge_idx] = static_cast<int64_t>(to_node);
+                }
+                ++edge_idx;
             }
         );
+        global_edge_idx = end_idx;
+        ++node_idx;
     }
-    else
+}
+
+template <typename Graph, typename Visit>
+pasl::pctl::parray<int64_t> expand_frontier(
+    Graph const& edges, pasl::pctl::parray<int64_t> const& frontier, Visit const& visit,
+    NodeLoopType loop_type = NodeLoopType::NonRangeCost, bool process_edges_in_parallel = false)
+{
+    uint64_t frontier_size = static_cast<uint64_t>(frontier.size());
+    pasl::pctl::parray<uint64_t> offsets = degrees_to_offsets(
+        pasl::pctl::parray<uint64_t>(
+            frontier.size(),
+            [&edges, &frontier](long node_idx)
+            {
+                assert(frontier[node_idx] >= 0);
+                return node_degree(edges, static_cast<uint64_t>(frontier[node_idx]));
+            }
+        )
+    );
+    uint64_t new_frontier_size = offsets[frontier_size];
+    pasl::pctl::parray<int64_t> new_frontier(static_cast<long>(new_frontier_size), static_cast<int64_t>(-1));
+
+    auto node_body = [&edges, &frontier, &visit, &offsets, &new_frontier, process_edges_in_parallel](uint64_t node_idx)
     {
-        std::vector<uint64_t> const& to_nodes = edges[from_node];
-        for (uint64_t edge_idx = 0; edge_idx < to_nodes.size(); ++edge_idx)
+        expand_node(edges, frontier, visit, offsets, new_frontier, node_idx, process_edges_in_parallel);
+    };
+    switch (loop_type)
+    {
+        case NodeLoopType::NonRange:
+            pasl::pctl::parallel_for(static_cast<uint64_t>(0), frontier_size, node_body);
+            break;
+        case NodeLoopType::NonRangeCost:
+            pasl::pctl::parallel_for(
+                static_cast<uint64_t>(0), frontier_size,
+                [&offsets](uint64_t node_idx)
+                {
+                    return offsets[node_idx + 1] - offsets[node_idx] + 1;
+                },
+                node_body
+            );
+            break;
+        case NodeLoopType::Range:
+            pasl::pctl::range::parallel_for(
+                static_cast<uint64_t>(0), frontier_size,
+                [&offsets](uint64_t left, uint64_t right)
+                {
+                    assert(left < right && right <= static_cast<uint64_t>(offsets.size() - 1));
+                    return offsets[right] - offsets[left] + (right - left);
+                },
+                node_body,
+                [&node_body](uint64_t left, uint64_t right)
+                {
+                    for (uint64_t node_idx = left; node_idx < right; ++node_idx)
+                    {
+                        node_body(node_idx);
+                    }
+                }
+            );
+            break;
+        case NodeLoopType::EdgeBalanced:
         {
-            process_single_edge(
-                result, new_frontier, to_nodes, 
-                start_idx, from_node, edge_idx
+            // the range body takes blocks [left, right), a single block is the same body with right = left + 1
+            auto blocks_body = [&edges, &frontier, &visit, &offsets, &new_frontier, new_frontier_size](
+                uint64_t left, uint64_t right)
+            {
+                expand_edge_range(
+                    edges, frontier, visit, offsets, new_frontier,
+                    left * EDGE_BLOCK_SIZE, std::min(new_frontier_size, right * EDGE_BLOCK_SIZE)
+                );
+            };
+            pasl::pctl::range::parallel_for(
+                static_cast<uint64_t>(0), (new_frontier_size + EDGE_BLOCK_SIZE - 1) / EDGE_BLOCK_SIZE,
+                [](uint64_t left, uint64_t right)
+                {
+                    return (right - left) * EDGE_BLOCK_SIZE;
+                },
+                [&blocks_body](uint64_t block_idx)
+                {
+                    blocks_body(block_idx, block_idx + 1);
+                },
+                blocks_body
             );
+            break;
         }
     }
+
+    return pasl::pctl::filter(
+        new_frontier.begin(), new_frontier.end(),
+        [](int64_t cur_node)
+        {
+            assert(cur_node >= -1);
+            return cur_node != -1;
+        }
+    );
 }
 
-inline pasl::pctl::parray<int64_t> bfs_cas(
-    uint64_t nodes_count, uint64_t start_node,
-    std::vector<std::vector<uint64_t>> const& edges,
+/*
+Parallel-CAS BFS
+*/
+
+/*
+One top-down level: every edge of the frontier tries to claim its destination with a CAS,
+returns the next frontier
+*/
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_cas_step(
+    Graph const& edges, pasl::pctl::parray<int64_t> const& cur_frontier, pasl::pctl::parray<int64_t>& result,
+    NodeLoopType loop_type, bool process_edges_in_parallel)
+{
+    assert(cur_frontier.size() > 0);
+    return expand_frontier(
+        edges, cur_frontier,
+        [&result](uint64_t from_node, uint64_t to_node, uint64_t)
+        {
+            int64_t new_result = __atomic_load_n(&result[from_node], __ATOMIC_SEQ_CST);
+            assert(new_result >= 0);
+            ++new_result;
+            int64_t expected_result = -1;
+            bool cas_result = __atomic_compare_exchange_n(
+                &result[to_node], &expected_result, new_result,
+                false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST
+            );
+            assert(cas_result || expected_result >= 0);
+            return cas_result;
+        },
+        loop_type, process_edges_in_parallel
+    );
+}
+
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_cas(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges,
     NodeLoopType loop_type, bool process_edges_in_parallel)
 {
     assert(0 <= start_node && start_node < nodes_count);
@@ -147,117 +319,446 @@ inline pasl::pctl::parray<int64_t> bfs_cas(
 
     while (true)
     {
-        assert(cur_frontier.size() > 0);
+        cur_frontier = bfs_cas_step(edges, cur_frontier, result, loop_type, process_edges_in_parallel);
+        if (cur_frontier.size() == 0)
+        {
+            return result;
+        }
+    }
+}
 
-        pasl::pctl::parray<uint64_t> sizes(
-            cur_frontier.size(),
-            [&cur_frontier, &edges, &result](uint64_t node_idx)
+/*
+Atomically replaces value with candidate, if candidate is smaller. Returns true, if the value was replaced.
+*/
+inline bool atomic_min(int64_t* value, int64_t candidate)
+{
+    int64_t cur_value = __atomic_load_n(value, __ATOMIC_RELAXED);
+    while (candidate < cur_value)
+    {
+        if (__atomic_compare_exchange_n(value, &cur_value, candidate, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+Returns true for the first thread, which writes round into the stamp of the node in this round
+*/
+inline bool claim_node(pasl::pctl::parray<uint64_t>& stamps, uint64_t node, uint64_t round)
+{
+    uint64_t stamp = __atomic_load_n(&stamps[node], __ATOMIC_RELAXED);
+    return stamp != round &&
+        __atomic_compare_exchange_n(&stamps[node], &stamp, round, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+/*
+Parallel-CAS BFS over the adaptive frontier: buffers are allocated once per traversal
+(or once for many traversals, if the frontier is passed in), so per-level work is proportional
+to the frontier and its edges
+*/
+
+/*
+SeqCstCas issues a sequentially consistent CAS for every edge, like bfs_cas.
+TestAndCas first reads the target with a relaxed load and skips visited nodes without a CAS,
+which keeps the cache line shared instead of pulling it exclusive, the CAS itself is acquire-release.
+Distances are only read after the traversal, so no stronger ordering is needed.
+*/
+enum struct VisitMarking
+{
+    SeqCstCas,
+    TestAndCas
+};
+
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_cas_adaptive(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, bfs_frontier& frontier,
+    VisitMarking marking = VisitMarking::SeqCstCas)
+{
+    assert(0 <= start_node && start_node < nodes_count);
+    pasl::pctl::parray<int64_t> result(nodes_count, static_cast<int64_t>(-1));
+    result[start_node] = 0;
+    frontier.reset(start_node);
+
+    int64_t cur_dist = 0;
+    while (frontier.size() > 0)
+    {
+        if (marking == VisitMarking::SeqCstCas)
+        {
+            frontier.advance(
+                edges,
+                [&result, cur_dist](uint64_t, uint64_t to_node)
+                {
+                    int64_t expected_result = -1;
+                    return __atomic_compare_exchange_n(
+                        &result[to_node], &expected_result, cur_dist + 1,
+                        false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST
+                    );
+                }
+            );
+        }
+        else
+        {
+            frontier.advance(
+                edges,
+                [&result, cur_dist](uint64_t, uint64_t to_node)
+                {
+                    if (__atomic_load_n(&result[to_node], __ATOMIC_RELAXED) != -1)
+                    {
+                        return false;
+                    }
+                    int64_t expected_result = -1;
+                    return __atomic_compare_exchange_n(
+                        &result[to_node], &expected_result, cur_dist + 1,
+                        false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED
+                    );
+                }
+            );
+        }
+        ++cur_dist;
+    }
+    return result;
+}
+
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_cas_adaptive(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges,
+    VisitMarking marking = VisitMarking::SeqCstCas)
+{
+    bfs_frontier frontier(nodes_count);
+    return bfs_cas_adaptive(nodes_count, start_node, edges, frontier, marking);
+}
+
+/*
+BFS with a visited bitset: nodes are claimed by setting their bit (a relaxed test first, then fetch_or),
+so the contended array is 64 times smaller than result. Only the claiming thread writes the distance,
+which is stored in 32 bits, -1 for unreachable nodes.
+*/
+template <typename Graph>
+pasl::pctl::parray<int32_t> bfs_visited_bitset(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, bfs_frontier& frontier)
+{
+    assert(0 <= start_node && start_node < nodes_count);
+    pasl::pctl::parray<int32_t> result(nodes_count, static_cast<int32_t>(-1));
+    pasl::pctl::parray<uint64_t> visited((nodes_count + 63) / 64, static_cast<uint64_t>(0));
+    result[start_node] = 0;
+    visited[start_node / 64] |= UINT64_C(1) << (start_node % 64);
+    frontier.reset(start_node);
+
+    int32_t cur_dist = 0;
+    while (frontier.size() > 0)
+    {
+        assert(cur_dist < INT32_MAX);
+        frontier.advance(
+            edges,
+            [&result, &visited, cur_dist](uint64_t, uint64_t to_node)
             {
-                return get_node_size_cas(cur_frontier, result, edges, node_idx);
+                uint64_t* word = &visited[to_node / 64];
+                uint64_t mask = UINT64_C(1) << (to_node % 64);
+                if ((__atomic_load_n(word, __ATOMIC_RELAXED) & mask) != 0)
+                {
+                    return false;
+                }
+                if ((__atomic_fetch_or(word, mask, __ATOMIC_ACQ_REL) & mask) != 0)
+                {
+                    return false;
+                }
+                result[to_node] = cur_dist + 1;
+                return true;
             }
         );
+        ++cur_dist;
+    }
+    return result;
+}
 
-        pasl::pctl::parray<uint64_t> pref_sizes = pasl::pctl::scan(
-            sizes.begin(), sizes.end(), static_cast<uint64_t>(0),
-            [](uint64_t x, uint64_t y)
+template <typename Graph>
+pasl::pctl::parray<int32_t> bfs_visited_bitset(uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+{
+    bfs_frontier frontier(nodes_count);
+    return bfs_visited_bitset(nodes_count, start_node, edges, frontier);
+}
+
+/*
+BFS over per-worker frontier lists, visited nodes are marked like in VisitMarking::TestAndCas
+*/
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_worker_buffers(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, worker_frontier& frontier)
+{
+    assert(0 <= start_node && start_node < nodes_count);
+    pasl::pctl::parray<int64_t> result(nodes_count, static_cast<int64_t>(-1));
+    result[start_node] = 0;
+    frontier.reset(start_node);
+
+    int64_t cur_dist = 0;
+    while (frontier.size() > 0)
+    {
+        frontier.advance(
+            edges,
+            [&result, cur_dist](uint64_t, uint64_t to_node)
             {
-                return x + y;
-            },
-            pasl::pctl::scan_type::forward_exclusive_scan
+                if (__atomic_load_n(&result[to_node], __ATOMIC_RELAXED) != -1)
+                {
+                    return false;
+                }
+                int64_t expected_result = -1;
+                return __atomic_compare_exchange_n(
+                    &result[to_node], &expected_result, cur_dist + 1,
+                    false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED
+                );
+            }
         );
-        assert(pref_sizes.size() == sizes.size());
+        ++cur_dist;
+    }
+    return result;
+}
 
-        uint64_t new_frontier_size = pref_sizes[pref_sizes.size() - 1] + sizes[sizes.size() - 1];
-        pasl::pctl::parray<int64_t> new_frontier(new_frontier_size, static_cast<int64_t>(-1));
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_worker_buffers(uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+{
+    worker_frontier frontier;
+    return bfs_worker_buffers(nodes_count, start_node, edges, frontier);
+}
 
-        switch(loop_type)
-        {
-            case NodeLoopType::NonRange: 
-                pasl::pctl::parallel_for(
-                    static_cast<uint64_t>(0), static_cast<uint64_t>(cur_frontier.size()),
-                    [
-                        &edges, &cur_frontier, &result, &new_frontier, &pref_sizes, 
-                        process_edges_in_parallel
-                    ](uint64_t node_idx)
-                    {
-                        process_single_node_cas(
-                            edges, cur_frontier, result, new_frontier, pref_sizes,
-                            node_idx, process_edges_in_parallel
-                        );
-                    }
-                );
-                break;
-            case NodeLoopType::NonRangeCost:
-                pasl::pctl::parallel_for(
-                    static_cast<uint64_t>(0), static_cast<uint64_t>(cur_frontier.size()),
-                    [&cur_frontier, &edges, &result](uint64_t node_idx)
-                    {
-                        return get_node_size_cas(cur_frontier, result, edges, node_idx);
-                    },
-                    [
-                        &edges, &cur_frontier, &result, &new_frontier, &pref_sizes, 
-                        process_edges_in_parallel
-                    ](uint64_t node_idx)
-                    {
-                        process_single_node_cas(
-                            edges, cur_frontier, result, new_frontier, pref_sizes, 
-                            node_idx, process_edges_in_parallel
-                        );
-                    }
+/*
+BFS tree output: result[v] is the node, from which v was discovered, result[start_node] == start_node
+and -1 for unreachable nodes. The parent is the value of the CAS, which claims the node, so no extra pass is needed.
+*/
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_cas_parents(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, bfs_frontier& frontier)
+{
+    assert(0 <= start_node && start_node < nodes_count);
+    pasl::pctl::parray<int64_t> result(nodes_count, static_cast<int64_t>(-1));
+    result[start_node] = static_cast<int64_t>(start_node);
+    frontier.reset(start_node);
+
+    while (frontier.size() > 0)
+    {
+        frontier.advance(
+            edges,
+            [&result](uint64_t from_node, uint64_t to_node)
+            {
+                if (__atomic_load_n(&result[to_node], __ATOMIC_RELAXED) != -1)
+                {
+                    return false;
+                }
+                int64_t expected_result = -1;
+                return __atomic_compare_exchange_n(
+                    &result[to_node], &expected_result, static_cast<int64_t>(from_node),
+                    false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED
                 );
-                break;
-            case NodeLoopType::Range:
-                pasl::pctl::range::parallel_for(
-                    static_cast<uint64_t>(0), static_cast<uint64_t>(cur_frontier.size()),
-                    [&pref_sizes, new_frontier_size](uint64_t left, uint64_t right)
-                    {
-                        assert(0 <= left && left < right && right <= pref_sizes.size());
-                        uint64_t end_size = new_frontier_size;
-                        if (right < pref_sizes.size())
-                        {
-                            end_size = pref_sizes[right];
-                        }
-                        return end_size - pref_sizes[left];
-                    },
-                    [
-                        &edges, &cur_frontier, &result, &new_frontier, &pref_sizes, 
-                        process_edges_in_parallel
-                    ](uint64_t node_idx)
-                    {
-                        process_single_node_cas(
-                            edges, cur_frontier, result, new_frontier, pref_sizes, 
-                            node_idx, process_edges_in_parallel
-                        );
-                    },
-                    [
-                        &edges, &cur_frontier, &result, &new_frontier, &pref_sizes, 
-                        process_edges_in_parallel
-                    ](uint64_t left, uint64_t right)
+            }
+        );
+    }
+    return result;
+}
+
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_cas_parents(uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+{
+    bfs_frontier frontier(nodes_count);
+    return bfs_cas_parents(nodes_count, start_node, edges, frontier);
+}
+
+/*
+Direction-optimizing BFS (Beamer et al.)
+*/
+
+/*
+Dense frontier: bit v of the bitmap is set when node v is in the frontier
+*/
+inline uint64_t bitmap_words_count(uint64_t nodes_count)
+{
+    return (nodes_count + 63) / 64;
+}
+
+inline bool bitmap_test(pasl::pctl::parray<uint64_t> const& bitmap, uint64_t node)
+{
+    return (bitmap[node / 64] >> (node % 64)) & 1;
+}
+
+inline void bitmap_set_atomic(pasl::pctl::parray<uint64_t>& bitmap, uint64_t node)
+{
+    __atomic_fetch_or(&bitmap[node / 64], UINT64_C(1) << (node % 64), __ATOMIC_RELAXED);
+}
+
+template <typename Graph>
+uint64_t frontier_degrees_sum(Graph const& edges, pasl::pctl::parray<int64_t> const& frontier)
+{
+    pasl::pctl::parray<uint64_t> degrees(
+        frontier.size(),
+        [&edges, &frontier](long node_idx)
+        {
+            return node_degree(edges, static_cast<uint64_t>(frontier[node_idx]));
+        }
+    );
+    return pasl::pctl::sum(degrees.begin(), degrees.end());
+}
+
+inline pasl::pctl::parray<uint64_t> sparse_to_dense(pasl::pctl::parray<int64_t> const& frontier, uint64_t nodes_count)
+{
+    pasl::pctl::parray<uint64_t> bitmap(bitmap_words_count(nodes_count), static_cast<uint64_t>(0));
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), frontier.size(),
+        [&frontier, &bitmap](long node_idx)
+        {
+            bitmap_set_atomic(bitmap, static_cast<uint64_t>(frontier[node_idx]));
+        }
+    );
+    return bitmap;
+}
+
+inline pasl::pctl::parray<int64_t> dense_to_sparse(pasl::pctl::parray<uint64_t> const& bitmap, uint64_t nodes_count)
+{
+    pasl::pctl::parray<int64_t> nodes(
+        nodes_count,
+        [&bitmap](long node)
+        {
+            return bitmap_test(bitmap, node) ? static_cast<int64_t>(node) : static_cast<int64_t>(-1);
+        }
+    );
+    return pasl::pctl::filter(
+        nodes.begin(), nodes.end(),
+        [](int64_t node)
+        {
+            return node != -1;
+        }
+    );
+}
+
+/*
+One bottom-up level: every unvisited node looks for an in-neighbor in the frontier and stops at the first one.
+Only the thread of the node writes its distance, so no CAS is needed, only bits of the next frontier
+are set atomically. Returns the number of nodes in the next frontier and the sum of their out-degrees.
+*/
+template <typename Graph>
+std::pair<uint64_t, uint64_t> bottom_up_step(
+    Graph const& out_edges, Graph const& in_edges, uint64_t nodes_count, int64_t cur_dist,
+    pasl::pctl::parray<uint64_t> const& cur_frontier, pasl::pctl::parray<uint64_t>& next_frontier,
+    pasl::pctl::parray<int64_t>& result)
+{
+    pasl::pctl::parallel_for(
+        static_cast<uint64_t>(0), nodes_count,
+        [&in_edges, cur_dist, &cur_frontier, &next_frontier, &result](uint64_t to_node)
+        {
+            if (result[to_node] != -1)
+            {
+                return;
+            }
+            for_each_neighbor_until(
+                in_edges, to_node,
+                [&cur_frontier, &next_frontier, &result, cur_dist, to_node](uint64_t from_node)
+                {
+                    if (!bitmap_test(cur_frontier, from_node))
                     {
-                        assert(0 <= left && left < right && right <= pref_sizes.size());
-                        for (uint64_t node_idx = left; node_idx < right; ++node_idx)
-                        {
-                            process_single_node_cas(
-                                edges, cur_frontier, result, new_frontier, pref_sizes, 
-                                node_idx, process_edges_in_parallel
-                            );
-                        }
+                        return false;
                     }
-                );
-                break;
+                    result[to_node] = cur_dist + 1;
+                    bitmap_set_atomic(next_frontier, to_node);
+                    return true;
+                }
+            );
         }
+    );
 
-        cur_frontier = pasl::pctl::filter(
-            new_frontier.begin(), new_frontier.end(),
-            [](int64_t cur_node)
-            {
-                assert(cur_node >= -1);
-                return cur_node != -1;
-            } 
-        );
-        if (cur_frontier.size() == 0)
+    long words_count = next_frontier.size();
+    pasl::pctl::parray<uint64_t> word_sizes(
+        words_count,
+        [&next_frontier](long word_idx)
+        {
+            return static_cast<uint64_t>(__builtin_popcountll(next_frontier[word_idx]));
+        }
+    );
+    pasl::pctl::parray<uint64_t> word_degrees(
+        words_count,
+        [&out_edges, &next_frontier](long word_idx)
         {
+            uint64_t result = 0;
+            uint64_t word = next_frontier[word_idx];
+            while (word != 0)
+            {
+                result += node_degree(out_edges, word_idx * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
             return result;
         }
+    );
+    return {
+        pasl::pctl::sum(word_sizes.begin(), word_sizes.end()),
+        pasl::pctl::sum(word_degrees.begin(), word_degrees.end())
+    };
+}
+
+/*
+Switches to bottom-up when the frontier has more than 1 / alpha of the unexplored edges
+and back to top-down when it has less than 1 / beta of the nodes.
+Top-down steps follow edges, bottom-up steps search in_edges, which must be the transposed edges.
+*/
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_direction_optimizing(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, Graph const& in_edges,
+    uint64_t alpha = 15, uint64_t beta = 18)
+{
+    assert(0 <= start_node && start_node < nodes_count);
+    pasl::pctl::parray<int64_t> result(nodes_count, static_cast<int64_t>(-1));
+    result[start_node] = 0;
+
+    pasl::pctl::parray<uint64_t> degrees(
+        nodes_count,
+        [&edges](long node)
+        {
+            return node_degree(edges, node);
+        }
+    );
+    uint64_t unexplored_edges = pasl::pctl::sum(degrees.begin(), degrees.end());
+
+    pasl::pctl::parray<int64_t> sparse_frontier = {static_cast<int64_t>(start_node)};
+    uint64_t frontier_size = 1;
+    uint64_t frontier_edges = node_degree(edges, start_node);
+    int64_t cur_dist = 0;
+
+    while (frontier_size > 0)
+    {
+        if (frontier_edges > unexplored_edges / alpha)
+        {
+            pasl::pctl::parray<uint64_t> dense_frontier = sparse_to_dense(sparse_frontier, nodes_count);
+            do
+            {
+                unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+                pasl::pctl::parray<uint64_t> next_frontier(
+                    bitmap_words_count(nodes_count), static_cast<uint64_t>(0)
+                );
+                std::tie(frontier_size, frontier_edges) = bottom_up_step(
+                    edges, in_edges, nodes_count, cur_dist, dense_frontier, next_frontier, result
+                );
+                dense_frontier = std::move(next_frontier);
+                ++cur_dist;
+            }
+            while (frontier_size > 0 && frontier_size >= nodes_count / beta);
+            sparse_frontier = dense_to_sparse(dense_frontier, nodes_count);
+        }
+        else
+        {
+            unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+            sparse_frontier = bfs_cas_step(edges, sparse_frontier, result, NodeLoopType::Range, false);
+            frontier_size = sparse_frontier.size();
+            frontier_edges = frontier_degrees_sum(edges, sparse_frontier);
+            ++cur_dist;
+        }
     }
+    return result;
+}
+
+/*
+Direction-optimizing BFS on a symmetric graph
+*/
+template <typename Graph>
+pasl::pctl::parray<int64_t> bfs_direction_optimizing(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges,
+    uint64_t alpha = 15, uint64_t beta = 18)
+{
+    return bfs_direction_optimizing(nodes_count, start_node, edges, edges, alpha, beta);
 }
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include <cstdint>
+#include <cassert>
+#include <utility>
+
+/*
+Parallel validation of BFS results in the style of Graph500: instead of comparing with a sequential BFS,
+local conditions are checked for every node and every edge. Together they hold only for a correct result:
+levels can not be larger than distances, since every edge goes at most one level down,
+and can not be smaller, since every reached node has a predecessor one level up.
+Work is linear in the size of the graph, plus O(n log(depth)) to compute levels of a tree.
+*/
+
+enum struct BfsValidationError
+{
+    None,
+    WrongStart,
+    NotATree,
+    MissingTreeEdge,
+    WrongLevel,
+    Unreached
+};
+
+/*
+Returns true, if check(node) holds for all nodes. cost(node) estimates the work for the node.
+*/
+template <typename Cost, typename Check>
+bool bfs_check_all_nodes(uint64_t nodes_count, Cost const& cost, Check const& check)
+{
+    bool failed = false;
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), static_cast<long>(nodes_count),
+        cost,
+        [&check, &failed](long node)
+        {
+            if (!check(static_cast<uint64_t>(node)))
+            {
+                __atomic_store_n(&failed, true, __ATOMIC_RELAXED);
+            }
+        }
+    );
+    return !failed;
+}
+
+template <typename Check>
+bool bfs_check_all_nodes(uint64_t nodes_count, Check const& check)
+{
+    return bfs_check_all_nodes(
+        nodes_count,
+        [](long)
+        {
+            return 1;
+        },
+        check
+    );
+}
+
+/*
+Checks every edge from a reached node: its end must be reached and at most one level deeper.
+has_predecessor[to_node] is set, if is_predecessor(from_node, to_node) holds for some edge.
+*/
+template <typename Graph, typename Levels, typename IsPredecessor>
+BfsValidationError check_bfs_edges(
+    uint64_t nodes_count, Graph const& edges, Levels const& levels, IsPredecessor const& is_predecessor,
+    pasl::pctl::parray<uint8_t>& has_predecessor)
+{
+    bool unreached = false;
+    bool wrong_level = false;
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), static_cast<long>(nodes_count),
+        [&edges](long node)
+        {
+            return node_degree(edges, node) + 1;
+        },
+        [&edges, &levels, &is_predecessor, &has_predecessor, &unreached, &wrong_level](long from_node)
+        {
+            int64_t from_level = levels[from_node];
+            if (from_level == -1)
+            {
+                return;
+            }
+            for_each_neighbor(
+                edges, static_cast<uint64_t>(from_node),
+                [
+                    &levels, &is_predecessor, &has_predecessor, &unreached, &wrong_level, from_node, from_level
+                ](uint64_t to_node)
+                {
+                    int64_t to_level = levels[to_node];
+                    if (to_level == -1)
+                    {
+                        __atomic_store_n(&unreached, true, __ATOMIC_RELAXED);
+                    }
+                    else if (to_level > from_level + 1)
+                    {
+                        __atomic_store_n(&wrong_level, true, __ATOMIC_RELAXED);
+                    }
+                    else if (is_predecessor(static_cast<uint64_t>(from_node), to_node))
+                    {
+                        __atomic_store_n(&has_predecessor[to_node], 1, __ATOMIC_RELAXED);
+                    }
+                }
+            );
+        }
+    );
+    if (unreached)
+    {
+        return BfsValidationError::Unreached;
+    }
+    if (wrong_level)
+    {
+        return BfsValidationError::WrongLevel;
+    }
+    return BfsValidationError::None;
+}
+
+/*
+Validates distances, -1 stands for unreachable nodes. Dists may be any array of signed integers.
+*/
+template <typename Graph, typename Dists>
+BfsValidationError validate_bfs_distances(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, Dists const& dists)
+{
+    assert(start_node < nodes_count);
+    bool valid_start = bfs_check_all_nodes(
+        nodes_count,
+        [&dists, start_node](uint64_t node)
+        {
+            int64_t dist = dists[node];
+            return node == start_node ? dist == 0 : dist == -1 || dist > 0;
+        }
+    );
+    if (!valid_start)
+    {
+        return BfsValidationError::WrongStart;
+    }
+
+    pasl::pctl::parray<uint8_t> has_predecessor(static_cast<long>(nodes_count), static_cast<uint8_t>(0));
+    BfsValidationError edges_error = check_bfs_edges(
+        nodes_count, edges, dists,
+        [&dists](uint64_t from_node, uint64_t to_node)
+        {
+            return static_cast<int64_t>(dists[to_node]) == static_cast<int64_t>(dists[from_node]) + 1;
+        },
+        has_predecessor
+    );
+    if (edges_error != BfsValidationError::None)
+    {
+        return edges_error;
+    }
+
+    bool all_have_predecessors = bfs_check_all_nodes(
+        nodes_count,
+        [&dists, &has_predecessor, start_node](uint64_t node)
+        {
+            return node == start_node || dists[node] == -1 || has_predecessor[node] != 0;
+        }
+    );
+    return all_have_predecessors ? BfsValidationError::None : BfsValidationError::WrongLevel;
+}
+
+/*
+Levels of the tree nodes by pointer jumping: after k rounds every node knows its ancestor 2^k levels up
+and the distance to it. Returns false, if some node does not reach start_node, i. e. parents have a cycle.
+Parents of reached nodes must be reached.
+*/
+inline bool bfs_tree_levels(
+    uint64_t start_node, pasl::pctl::parray<int64_t> const& parents, pasl::pctl::parray<int64_t>& levels)
+{
+    long nodes_count = parents.size();
+    int64_t root = static_cast<int64_t>(start_node);
+    pasl::pctl::parray<int64_t> ancestors(
+        nodes_count,
+        [&parents, root](long node)
+        {
+            return parents[node] == -1 ? root : parents[node];
+        }
+    );
+    levels = pasl::pctl::parray<int64_t>(
+        nodes_count,
+        [&parents, root](long node)
+        {
+            if (parents[node] == -1)
+            {
+                return static_cast<int64_t>(-1);
+            }
+            return node == root ? static_cast<int64_t>(0) : static_cast<int64_t>(1);
+        }
+    );
+
+    for (uint32_t round = 0; ; ++round)
+    {
+        pasl::pctl::parray<uint64_t> not_finished(
+            nodes_count,
+            [&ancestors, root](long node)
+            {
+                return static_cast<uint64_t>(ancestors[node] != root);
+            }
+        );
+        if (pasl::pctl::sum(not_finished.begin(), not_finished.end()) == 0)
+        {
+            return true;
+        }
+        if ((UINT64_C(1) << round) >= static_cast<uint64_t>(nodes_count))
+        {
+            return false;
+        }
+        // the root is its own ancestor at level 0, so finished nodes do not change
+        pasl::pctl::parray<int64_t> next_levels(
+            nodes_count,
+            [&ancestors, &levels](long node)
+            {
+                return levels[node] + levels[ancestors[node]];
+            }
+        );
+        pasl::pctl::parray<int64_t> next_ancestors(
+            nodes_count,
+            [&ancestors](long node)
+            {
+                return ancestors[ancestors[node]];
+            }
+        );
+        levels = std::move(next_levels);
+        ancestors = std::move(next_ancestors);
+    }
+}
+
+/*
+Validates a BFS tree, as returned by bfs_cas_parents: parents[start_node] == start_node,
+-1 stands for unreachable nodes
+*/
+template <typename Graph>
+BfsValidationError validate_bfs_tree(
+    uint64_t nodes_count, uint64_t start_node, Graph const& edges, pasl::pctl::parray<int64_t> const& parents)
+{
+    assert(start_node < nodes_count);
+    assert(parents.size() == static_cast<long>(nodes_count));
+    if (parents[start_node] != static_cast<int64_t>(start_node))
+    {
+        return BfsValidationError::WrongStart;
+    }
+
+    bool valid_parents = bfs_check_all_nodes(
+        nodes_count,
+        [&parents, nodes_count, start_node](uint64_t node)
+        {
+            int64_t parent = parents[node];
+            if (node == start_node || parent == -1)
+            {
+                return true;
+            }
+            return 0 <= parent && static_cast<uint64_t>(parent) < nodes_count &&
+                static_cast<uint64_t>(parent) != node && parents[parent] != -1;
+        }
+    );
+    pasl::pctl::parray<int64_t> levels;
+    if (!valid_parents || !bfs_tree_levels(start_node, parents, levels))
+    {
+        return BfsValidationError::NotATree;
+    }
+
+    pasl::pctl::parray<uint8_t> is_tree_edge(static_cast<long>(nodes_count), static_cast<uint8_t>(0));
+    BfsValidationError edges_error = check_bfs_edges(
+        nodes_count, edges, levels,
+        [&parents](uint64_t from_node, uint64_t to_node)
+        {
+            return parents[to_node] == static_cast<int64_t>(from_node);
+        },
+        is_tree_edge
+    );
+    if (edges_error != BfsValidationError::None)
+    {
+        return edges_error;
+    }
+
+    bool all_tree_edges = bfs_check_all_nodes(
+        nodes_count,
+        [&parents, &is_tree_edge, start_node](uint64_t node)
+        {
+            return node == start_node || parents[node] == -1 || is_tree_edge[node] != 0;
+        }
+    );
+    return all_tree_edges ? BfsValidationError::None : BfsValidationError::MissingTreeEdge;
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include "bfs.h"
+#include <cstdint>
+#include <cassert>
+#include <utility>
+
+/*
+Concurrent open addressing map from nodes to distances with linear probing. A node is claimed
+by a CAS on its key, the value is written by the claiming thread only and must not be read
+until the end of the parallel phase, which inserted it. Memory is proportional to the number of entries,
+not to the number of nodes of the graph.
+*/
+struct concurrent_node_map
+{
+public:
+    concurrent_node_map(uint64_t capacity = 64) :
+        _capacity(round_capacity(capacity)),
+        _keys(static_cast<long>(_capacity), EMPTY_KEY),
+        _values(static_cast<long>(_capacity))
+    {
+    }
+
+    uint64_t capacity() const
+    {
+        return _capacity;
+    }
+
+    /*
+    Returns false, if the node is already in the map. Can be called concurrently with other insertions.
+    */
+    bool insert(uint64_t node, int64_t value)
+    {
+        assert(node != EMPTY_KEY);
+        for (uint64_t slot = hash(node); ; slot = (slot + 1) & (_capacity - 1))
+        {
+            uint64_t key = __atomic_load_n(&_keys[slot], __ATOMIC_RELAXED);
+            if (key == node)
+            {
+                return false;
+            }
+            if (key != EMPTY_KEY)
+            {
+                continue;
+            }
+            uint64_t expected_key = EMPTY_KEY;
+            if (__atomic_compare_exchange_n(&_keys[slot], &expected_key, node, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            {
+                _values[slot] = value;
+                return true;
+            }
+            if (expected_key == node)
+            {
+                return false;
+            }
+        }
+    }
+
+    /*
+    Returns -1, if the node is not in the map
+    */
+    int64_t find(uint64_t node) const
+    {
+        for (uint64_t slot = hash(node); ; slot = (slot + 1) & (_capacity - 1))
+        {
+            uint64_t key = _keys[slot];
+            if (key == node)
+            {
+                return _values[slot];
+            }
+            if (key == EMPTY_KEY)
+            {
+                return -1;
+            }
+        }
+    }
+
+    /*
+    Grows the map, so that it keeps at most half of the slots occupied with size entries. Not thread-safe.
+    */
+    void reserve(uint64_t size)
+    {
+        if (2 * size <= _capacity)
+        {
+            return;
+        }
+        concurrent_node_map result(2 * size);
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), static_cast<long>(_capacity),
+            [this, &result](long slot)
+            {
+                if (_keys[slot] != EMPTY_KEY)
+                {
+                    result.insert(_keys[slot], _values[slot]);
+                }
+            }
+        );
+        *this = std::move(result);
+    }
+private:
+    static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+
+    static uint64_t round_capacity(uint64_t capacity)
+    {
+        uint64_t result = 2;
+        while (result < capacity)
+        {
+            result *= 2;
+        }
+        return result;
+    }
+
+    uint64_t hash(uint64_t node) const
+    {
+        return (node * UINT64_C(0x9e3779b97f4a7c15)) >> (64 - __builtin_ctzll(_capacity));
+    }
+
+    uint64_t                     _capacity;
+    pasl::pctl::parray<uint64_t> _keys;
+    pasl::pctl::parray<int64_t>  _values;
+};
+
+/*
+Expands one side by a level. Neighbors, which are visited by the other side, are not inserted,
+but give the candidate length of a path through them, the minimal one is kept in best_dist.
+visited_count is the number of entries in visited.
+*/
+template <typename Graph>
+pasl::pctl::parray<int64_t> bidirectional_bfs_step(
+    Graph const& edges, pasl::pctl::parray<int64_t> const& frontier, int64_t cur_dist, uint64_t visited_count,
+    concurrent_node_map& visited, concurrent_node_map const& other_visited, int64_t& best_dist)
+{
+    visited.reserve(visited_count + frontier_degrees_sum(edges, frontier));
+    return expand_frontier(
+        edges, frontier,
+        [cur_dist, &visited, &other_visited, &best_dist](uint64_t, uint64_t to_node, uint64_t)
+        {
+            int64_t other_dist = other_visited.find(to_node);
+            if (other_dist != -1)
+            {
+                atomic_min(&best_dist, cur_dist + 1 + other_dist);
+                return false;
+            }
+            return visited.insert(to_node, cur_dist + 1);
+        }
+    );
+}
+
+/*
+Parallel bidirectional BFS: the distance from start_node to target_node, -1 if it is unreachable.
+The side with less edges in its frontier is expanded by a whole level, the search stops after the first level,
+at which the sides meet. Visited nodes are kept in hash maps, so the work and memory depend only on the explored part
+of the graph. in_edges must be the transposed out_edges.
+*/
+template <typename Graph>
+int64_t bfs_bidirectional(
+    [[maybe_unused]] uint64_t nodes_count, uint64_t start_node, uint64_t target_node,
+    Graph const& out_edges, Graph const& in_edges)
+{
+    assert(start_node < nodes_count && target_node < nodes_count);
+    if (start_node == target_node)
+    {
+        return 0;
+    }
+    concurrent_node_map forward_visited;
+    concurrent_node_map backward_visited;
+    forward_visited.insert(start_node, 0);
+    backward_visited.insert(target_node, 0);
+    pasl::pctl::parray<int64_t> forward_frontier = {static_cast<int64_t>(start_node)};
+    pasl::pctl::parray<int64_t> backward_frontier = {static_cast<int64_t>(target_node)};
+    int64_t forward_dist = 0;
+    int64_t backward_dist = 0;
+    uint64_t forward_count = 1;
+    uint64_t backward_count = 1;
+
+    while (forward_frontier.size() > 0 && backward_frontier.size() > 0)
+    {
+        int64_t best_dist = INT64_MAX;
+        if (frontier_degrees_sum(out_edges, forward_frontier) <= frontier_degrees_sum(in_edges, backward_frontier))
+        {
+            forward_frontier = bidirectional_bfs_step(
+                out_edges, forward_frontier, forward_dist, forward_count,
+                forward_visited, backward_visited, best_dist
+            );
+            ++forward_dist;
+            forward_count += forward_frontier.size();
+        }
+        else
+        {
+            backward_frontier = bidirectional_bfs_step(
+                in_edges, backward_frontier, backward_dist, backward_count,
+                backward_visited, forward_visited, best_dist
+            );
+            ++backward_dist;
+            backward_count += backward_frontier.size();
+        }
+        if (best_dist != INT64_MAX)
+        {
+            return best_dist;
+        }
+    }
+    return -1;
+}
+
+/*
+Bidirectional BFS on a symmetric graph
+*/
+template <typename Graph>
+int64_t bfs_bidirectional(uint64_t nodes_count, uint64_t start_node, uint64_t target_node, Graph const& edges)
+{
+    return bfs_bidirectional(nodes_count, start_node, target_node, edges, edges);
+}
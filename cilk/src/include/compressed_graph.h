@@ -0,0 +1,279 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include <cstdint>
+#include <cassert>
+#include <utility>
+
+/*
+Byte-aligned varints: 7 bits of the value per byte, the high bit is set in all bytes but the last
+*/
+
+inline uint64_t varint_size(uint64_t value)
+{
+    uint64_t result = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        ++result;
+    }
+    return result;
+}
+
+inline uint8_t* encode_varint(uint8_t* dst, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *dst++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *dst++ = static_cast<uint8_t>(value);
+    return dst;
+}
+
+inline uint64_t decode_varint(uint8_t const*& src)
+{
+    uint64_t result = *src & 0x7f;
+    uint32_t shift = 7;
+    while (*src++ & 0x80)
+    {
+        result |= static_cast<uint64_t>(*src & 0x7f) << shift;
+        shift += 7;
+    }
+    return result;
+}
+
+inline uint64_t zigzag_encode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/*
+Compressed CSR (Ligra+ style): the list of node v starts at bytes[offsets[v]] and holds the degree,
+the difference between the first neighbor and v (zigzag encoded, since it may be negative)
+and the differences between consecutive neighbors, which are non-negative because lists are sorted.
+Neighbors can only be decoded sequentially, so node_neighbor takes time linear in edge_idx
+and for_each_neighbor or for_each_neighbor_until should be used instead wherever possible.
+*/
+
+struct compressed_graph
+{
+public:
+    compressed_graph(
+        pasl::pctl::parray<uint64_t>&& offsets, pasl::pctl::parray<uint8_t>&& bytes, uint64_t edges_count) :
+        _offsets(std::move(offsets)),
+        _bytes(std::move(bytes)),
+        _edges_count(edges_count)
+    {
+        assert(_offsets.size() > 0);
+        assert(_offsets[_offsets.size() - 1] == static_cast<uint64_t>(_bytes.size()));
+    }
+
+    uint64_t nodes_count() const
+    {
+        return static_cast<uint64_t>(_offsets.size() - 1);
+    }
+
+    uint64_t edges_count() const
+    {
+        return _edges_count;
+    }
+
+    uint64_t bytes_count() const
+    {
+        return static_cast<uint64_t>(_bytes.size());
+    }
+
+    uint64_t degree(uint64_t node) const
+    {
+        assert(node < nodes_count());
+        uint8_t const* src = _bytes.begin() + _offsets[node];
+        return decode_varint(src);
+    }
+
+    uint64_t neighbor(uint64_t node, uint64_t edge_idx) const
+    {
+        assert(edge_idx < degree(node));
+        uint64_t result = 0;
+        uint64_t cur_idx = 0;
+        for_each_neighbor_until(
+            node,
+            [&result, &cur_idx, edge_idx](uint64_t to_node)
+            {
+                result = to_node;
+                return cur_idx++ == edge_idx;
+            }
+        );
+        return result;
+    }
+
+    template <typename F>
+    void for_each_neighbor(uint64_t node, F&& f) const
+    {
+        for_each_neighbor_until(
+            node,
+            [&f](uint64_t to_node)
+            {
+                f(to_node);
+                return false;
+            }
+        );
+    }
+
+    /*
+    Decoding stops at the first neighbor, for which f returned true
+    */
+    template <typename F>
+    void for_each_neighbor_until(uint64_t node, F&& f) const
+    {
+        assert(node < nodes_count());
+        uint8_t const* src = _bytes.begin() + _offsets[node];
+        uint64_t degree = decode_varint(src);
+        if (degree == 0)
+        {
+            return;
+        }
+        uint64_t to_node = static_cast<uint64_t>(static_cast<int64_t>(node) + zigzag_decode(decode_varint(src)));
+        if (f(to_node))
+        {
+            return;
+        }
+        for (uint64_t edge_idx = 1; edge_idx < degree; ++edge_idx)
+        {
+            to_node += decode_varint(src);
+            if (f(to_node))
+            {
+                return;
+            }
+        }
+        assert(src == _bytes.begin() + _offsets[node + 1]);
+    }
+
+    pasl::pctl::parray<uint64_t> const& get_offsets() const
+    {
+        return _offsets;
+    }
+
+    pasl::pctl::parray<uint8_t> const& get_bytes() const
+    {
+        return _bytes;
+    }
+private:
+    pasl::pctl::parray<uint64_t> _offsets;
+    pasl::pctl::parray<uint8_t>  _bytes;
+    uint64_t                     _edges_count;
+};
+
+inline uint64_t node_degree(compressed_graph const& graph, uint64_t node)
+{
+    return graph.degree(node);
+}
+
+inline uint64_t node_neighbor(compressed_graph const& graph, uint64_t node, uint64_t edge_idx)
+{
+    return graph.neighbor(node, edge_idx);
+}
+
+template <typename F>
+void for_each_neighbor(compressed_graph const& graph, uint64_t node, F&& f)
+{
+    graph.for_each_neighbor(node, f);
+}
+
+template <typename F>
+void for_each_neighbor_until(compressed_graph const& graph, uint64_t node, F&& f)
+{
+    graph.for_each_neighbor_until(node, f);
+}
+
+template <typename F>
+void for_each_neighbor_range(compressed_graph const& graph, uint64_t node, uint64_t first, uint64_t last, F&& f)
+{
+    for_each_neighbor_range_sequential(graph, node, first, last, f);
+}
+
+template <>
+struct has_indexed_neighbors<compressed_graph> : std::false_type
+{
+};
+
+inline uint64_t graph_memory_bytes(compressed_graph const& graph)
+{
+    return sizeof(compressed_graph) + (graph.nodes_count() + 1) * sizeof(uint64_t) + graph.bytes_count();
+}
+
+/*
+Encodes the list of the node into dst (if dst is not nullptr) and returns its size in bytes
+*/
+template <typename V>
+uint64_t encode_neighbors(csr_graph<V> const& graph, uint64_t node, uint8_t* dst)
+{
+    uint64_t degree = graph.degree(node);
+    uint64_t result = varint_size(degree);
+    if (dst != nullptr)
+    {
+        dst = encode_varint(dst, degree);
+    }
+    uint64_t prev_node = node;
+    for (uint64_t edge_idx = 0; edge_idx < degree; ++edge_idx)
+    {
+        uint64_t to_node = static_cast<uint64_t>(graph.neighbor(node, edge_idx));
+        uint64_t value = 0;
+        if (edge_idx == 0)
+        {
+            value = zigzag_encode(static_cast<int64_t>(to_node) - static_cast<int64_t>(node));
+        }
+        else
+        {
+            assert(to_node >= prev_node && "neighbor lists must be sorted");
+            value = to_node - prev_node;
+        }
+        result += varint_size(value);
+        if (dst != nullptr)
+        {
+            dst = encode_varint(dst, value);
+        }
+        prev_node = to_node;
+    }
+    return result;
+}
+
+/*
+Parallel encoding: sizes of all lists are computed first, then a scan gives their offsets
+and every list is encoded independently
+*/
+template <typename V>
+compressed_graph compress_graph(csr_graph<V> const& graph)
+{
+    long nodes_count = static_cast<long>(graph.nodes_count());
+    pasl::pctl::parray<uint64_t> offsets = degrees_to_offsets(
+        pasl::pctl::parray<uint64_t>(
+            nodes_count,
+            [&graph](long node)
+            {
+                return encode_neighbors(graph, node, nullptr);
+            }
+        )
+    );
+
+    pasl::pctl::parray<uint8_t> bytes(static_cast<long>(offsets[nodes_count]));
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes_count,
+        [&graph](long node)
+        {
+            return graph.degree(node) + 1;
+        },
+        [&graph, &offsets, &bytes](long node)
+        {
+            encode_neighbors(graph, node, bytes.begin() + offsets[node]);
+        }
+    );
+    return compressed_graph(std::move(offsets), std::move(bytes), graph.edges_count());
+}
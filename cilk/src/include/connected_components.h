@@ -0,0 +1,219 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include <cstdint>
+#include <cassert>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/*
+Connected components. Components are numbered in the order of their minimal nodes,
+so the result does not depend on scheduling and equals the result of the sequential algorithm.
+Edges are treated as undirected, so weakly connected components are found in directed graphs.
+*/
+
+struct connected_components
+{
+    // component of every node
+    pasl::pctl::parray<uint64_t> labels;
+    // number of nodes of every component
+    pasl::pctl::parray<uint64_t> sizes;
+};
+
+/*
+Sequential baseline, BFS from the minimal unvisited node. The graph must be symmetric.
+*/
+template <typename Graph>
+connected_components connected_components_sequential(uint64_t nodes_count, Graph const& edges)
+{
+    uint64_t const unvisited = UINT64_MAX;
+    pasl::pctl::parray<uint64_t> labels(static_cast<long>(nodes_count), unvisited);
+    std::vector<uint64_t> sizes;
+    std::queue<uint64_t> q;
+    for (uint64_t start_node = 0; start_node < nodes_count; ++start_node)
+    {
+        if (labels[start_node] != unvisited)
+        {
+            continue;
+        }
+        uint64_t component = sizes.size();
+        sizes.push_back(1);
+        labels[start_node] = component;
+        q.push(start_node);
+        while (!q.empty())
+        {
+            uint64_t from_node = q.front();
+            q.pop();
+            for_each_neighbor(
+                edges, from_node,
+                [&labels, &sizes, &q, component, unvisited](uint64_t to_node)
+                {
+                    if (labels[to_node] == unvisited)
+                    {
+                        labels[to_node] = component;
+                        ++sizes[component];
+                        q.push(to_node);
+                    }
+                }
+            );
+        }
+    }
+    return {
+        std::move(labels),
+        pasl::pctl::parray<uint64_t>(
+            static_cast<long>(sizes.size()),
+            [&sizes](long component)
+            {
+                return sizes[component];
+            }
+        )
+    };
+}
+
+/*
+Root of the tree of the node in the concurrent union-find, with path halving:
+every visited node is relinked to its grandparent by a CAS, failed CASes are ignored
+*/
+inline uint64_t union_find_root(pasl::pctl::parray<uint64_t>& parents, uint64_t node)
+{
+    while (true)
+    {
+        uint64_t parent = __atomic_load_n(&parents[node], __ATOMIC_RELAXED);
+        if (parent == node)
+        {
+            return node;
+        }
+        uint64_t grandparent = __atomic_load_n(&parents[parent], __ATOMIC_RELAXED);
+        if (parent != grandparent)
+        {
+            __atomic_compare_exchange_n(
+                &parents[node], &parent, grandparent, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED
+            );
+        }
+        node = grandparent;
+    }
+}
+
+/*
+The larger root is linked to the smaller one, so links always go down by id and no cycles appear.
+The CAS fails, if the root was linked concurrently, then the roots are searched again.
+*/
+inline void union_find_unite(pasl::pctl::parray<uint64_t>& parents, uint64_t x, uint64_t y)
+{
+    while (true)
+    {
+        x = union_find_root(parents, x);
+        y = union_find_root(parents, y);
+        if (x == y)
+        {
+            return;
+        }
+        if (x < y)
+        {
+            std::swap(x, y);
+        }
+        uint64_t expected_parent = x;
+        if (__atomic_compare_exchange_n(&parents[x], &expected_parent, y, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        {
+            return;
+        }
+    }
+}
+
+/*
+Nodes of one component often have consecutive ids, so runs of equal labels are counted locally
+and added to sizes with one fetch_add, which keeps the counter of a giant component uncontended
+*/
+inline void add_component_sizes(
+    pasl::pctl::parray<uint64_t> const& labels, long left, long right, pasl::pctl::parray<uint64_t>& sizes)
+{
+    long run_start = left;
+    for (long node = left + 1; node <= right; ++node)
+    {
+        if (node == right || labels[node] != labels[run_start])
+        {
+            __atomic_fetch_add(&sizes[labels[run_start]], static_cast<uint64_t>(node - run_start), __ATOMIC_RELAXED);
+            run_start = node;
+        }
+    }
+}
+
+/*
+Parallel connected components by concurrent union-find: all edges are united in parallel,
+then every node is compressed to its root, which is the minimal node of the component.
+Roots are numbered by a scan.
+*/
+template <typename Graph>
+connected_components connected_components_union_find(uint64_t nodes_count, Graph const& edges)
+{
+    long n = static_cast<long>(nodes_count);
+    pasl::pctl::parray<uint64_t> parents(
+        n,
+        [](long node)
+        {
+            return static_cast<uint64_t>(node);
+        }
+    );
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), n,
+        [&edges](long node)
+        {
+            return node_degree(edges, node) + 1;
+        },
+        [&edges, &parents](long from_node)
+        {
+            for_each_neighbor(
+                edges, static_cast<uint64_t>(from_node),
+                [&parents, from_node](uint64_t to_node)
+                {
+                    union_find_unite(parents, static_cast<uint64_t>(from_node), to_node);
+                }
+            );
+        }
+    );
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), n,
+        [&parents](long node)
+        {
+            __atomic_store_n(&parents[node], union_find_root(parents, static_cast<uint64_t>(node)), __ATOMIC_RELAXED);
+        }
+    );
+
+    pasl::pctl::parray<uint64_t> component_offsets = degrees_to_offsets(
+        pasl::pctl::parray<uint64_t>(
+            n,
+            [&parents](long node)
+            {
+                return static_cast<uint64_t>(parents[node] == static_cast<uint64_t>(node));
+            }
+        )
+    );
+    uint64_t components_count = component_offsets[n];
+    pasl::pctl::parray<uint64_t> labels(
+        n,
+        [&parents, &component_offsets](long node)
+        {
+            return component_offsets[parents[node]];
+        }
+    );
+    pasl::pctl::parray<uint64_t> sizes(static_cast<long>(components_count), static_cast<uint64_t>(0));
+    pasl::pctl::range::parallel_for(
+        static_cast<long>(0), n,
+        [](long left, long right)
+        {
+            return right - left;
+        },
+        [&labels, &sizes](long node)
+        {
+            add_component_sizes(labels, node, node + 1, sizes);
+        },
+        [&labels, &sizes](long left, long right)
+        {
+            add_component_sizes(labels, left, right, sizes);
+        }
+    );
+    return {std::move(labels), std::move(sizes)};
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include "bfs.h"
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/*
+Atomically lowers the distance, -1 stands for infinity. Returns true, if the distance was lowered.
+*/
+inline bool improve_distance(int64_t* dist, int64_t candidate)
+{
+    int64_t cur_dist = __atomic_load_n(dist, __ATOMIC_RELAXED);
+    while (cur_dist == -1 || candidate < cur_dist)
+    {
+        if (__atomic_compare_exchange_n(dist, &cur_dist, candidate, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+BFS distances from a fixed source, which are maintained under insertions of edges.
+An inserted edge lowers the distance of its end at most, such ends are the seeds of the update.
+Seeds are injected into a level-synchronous BFS at the levels of their new distances, so every node
+gets its final distance at once and the work of an update is proportional to the edges
+of the nodes, whose distances changed, plus the size of the batch.
+*/
+struct dynamic_bfs
+{
+public:
+    dynamic_bfs(adjacency_list&& edges, uint64_t start_node, bool symmetric) :
+        _edges(std::move(edges)),
+        _start_node(start_node),
+        _symmetric(symmetric),
+        _dists(bfs_cas_adaptive(_edges.size(), start_node, _edges, VisitMarking::TestAndCas))
+    {
+    }
+
+    uint64_t nodes_count() const
+    {
+        return _edges.size();
+    }
+
+    uint64_t get_start_node() const
+    {
+        return _start_node;
+    }
+
+    adjacency_list const& get_graph() const
+    {
+        return _edges;
+    }
+
+    pasl::pctl::parray<int64_t> const& get_distances() const
+    {
+        return _dists;
+    }
+
+    /*
+    Inserts the edges (in both directions, if the graph is symmetric) and updates distances.
+    Returns the number of expanded nodes, which is the number of changed distances, unless a seed
+    was lowered again by an earlier level.
+    */
+    uint64_t insert_edges(std::vector<std::pair<uint64_t, uint64_t>> const& new_edges)
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> inserted(new_edges);
+        if (_symmetric)
+        {
+            for (auto [from_node, to_node] : new_edges)
+            {
+                inserted.push_back({to_node, from_node});
+            }
+        }
+        for (auto [from_node, to_node] : inserted)
+        {
+            assert(from_node < nodes_count() && to_node < nodes_count());
+            _edges[from_node].push_back(to_node);
+        }
+
+        // a source of one inserted edge may be lowered by another, it then becomes a seed itself
+        pasl::pctl::parray<int64_t> lowered(
+            static_cast<long>(inserted.size()),
+            [this, &inserted](long edge_idx)
+            {
+                auto [from_node, to_node] = inserted[edge_idx];
+                int64_t from_dist = __atomic_load_n(&_dists[from_node], __ATOMIC_RELAXED);
+                if (from_dist == -1 || !improve_distance(&_dists[to_node], from_dist + 1))
+                {
+                    return static_cast<int64_t>(-1);
+                }
+                return static_cast<int64_t>(to_node);
+            }
+        );
+        std::vector<std::pair<int64_t, uint64_t>> seeds;
+        for (int64_t node : lowered)
+        {
+            if (node != -1)
+            {
+                seeds.push_back({_dists[node], static_cast<uint64_t>(node)});
+            }
+        }
+        std::sort(seeds.begin(), seeds.end());
+        seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
+
+        uint64_t result = seeds.size();
+        uint64_t next_seed = 0;
+        pasl::pctl::parray<int64_t> frontier;
+        int64_t cur_dist = 0;
+        while (frontier.size() > 0 || next_seed < seeds.size())
+        {
+            if (frontier.size() == 0)
+            {
+                cur_dist = seeds[next_seed].first;
+            }
+            std::vector<int64_t> level_seeds;
+            for (; next_seed < seeds.size() && seeds[next_seed].first == cur_dist; ++next_seed)
+            {
+                // a seed, which was lowered again by an earlier level, has already been expanded
+                uint64_t node = seeds[next_seed].second;
+                if (_dists[node] == cur_dist)
+                {
+                    level_seeds.push_back(static_cast<int64_t>(node));
+                }
+            }
+            if (level_seeds.size() > 0)
+            {
+                long frontier_size = frontier.size();
+                frontier = pasl::pctl::parray<int64_t>(
+                    frontier_size + static_cast<long>(level_seeds.size()),
+                    [&frontier, &level_seeds, frontier_size](long node_idx)
+                    {
+                        return node_idx < frontier_size ? frontier[node_idx] : level_seeds[node_idx - frontier_size];
+                    }
+                );
+            }
+
+            frontier = expand_frontier(
+                _edges, frontier,
+                [this, cur_dist](uint64_t, uint64_t to_node, uint64_t)
+                {
+                    return improve_distance(&_dists[to_node], cur_dist + 1);
+                }
+            );
+            result += frontier.size();
+            ++cur_dist;
+        }
+        return result;
+    }
+private:
+    adjacency_list              _edges;
+    uint64_t                    _start_node;
+    bool                        _symmetric;
+    pasl::pctl::parray<int64_t> _dists;
+};
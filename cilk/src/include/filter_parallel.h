@@ -1,6 +1,7 @@
 #pragma once
 
 #include "raw_array.h"
+#include "array_view.h"
 #include "map_parallel.h"
 #include "scan.h"
 #include <cilk/cilk.h>
@@ -8,9 +9,15 @@
 #include <functional>
 #include <cstdint>
 #include <cassert>
+#include <new>
+#include <utility>
 
-template <typename T>
-raw_array<T> filter_parallel(raw_array<T> const& vals, std::function<bool(T const&)> pred, uint32_t blocks_count)
+/*
+Each selected element vals[j] is passed to place(dst, vals[j]), which should construct it at dst
+*/
+template <typename T, typename V, typename Place>
+raw_array<T> do_filter_parallel(
+    array_view<V> vals, std::function<bool(T const&)> const& pred, uint32_t blocks_count, Place const& place)
 {
     assert(blocks_count > 0);
     if (vals.size() == 0)
@@ -44,7 +51,7 @@ raw_array<T> filter_parallel(raw_array<T> const& vals, std::function<bool(T cons
     auto [idxs, total_elems] = scan_exclusive_blocked(flags, blocks_count);
     assert(idxs.size() == vals.size());
     
-    raw_array<T> res(total_elems);
+    raw_array<T> res = raw_array<T>::uninitialized(total_elems);
 
     #pragma grainsize 1
     cilk_for (uint32_t i = 0; i < blocks_count; ++i)
@@ -59,9 +66,36 @@ raw_array<T> filter_parallel(raw_array<T> const& vals, std::function<bool(T cons
         {
             if (flags[j] == 1)
             {
-                res[idxs[j]] = vals[j];
+                place(res.get_raw_ptr() + idxs[j], vals[j]);
             }
         }
     }
     return res;
 }
+
+template <typename T>
+raw_array<T> filter_parallel(array_view<T const> vals, std::function<bool(T const&)> pred, uint32_t blocks_count)
+{
+    return do_filter_parallel<T>(
+        vals, pred, blocks_count,
+        [](T* dst, T const& val)
+        {
+            new (dst) T(val);
+        }
+    );
+}
+
+/*
+Same as filter_parallel, but selected elements are moved out of vals instead of being copied
+*/
+template <typename T>
+raw_array<T> filter_parallel_move(array_view<T> vals, std::function<bool(T const&)> pred, uint32_t blocks_count)
+{
+    return do_filter_parallel<T>(
+        vals, pred, blocks_count,
+        [](T* dst, T& val)
+        {
+            new (dst) T(std::move(val));
+        }
+    );
+}
@@ -0,0 +1,403 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include <cstdint>
+#include <cassert>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <cilk/cilk_api.h>
+
+/*
+BFS frontier that switches between a sparse list of nodes and a dense bitmap.
+All buffers are allocated once for the whole traversal: every node enters the frontier at most once,
+so lists of nodes_count elements always suffice and no per-level padding by degree is needed.
+New nodes are appended through small local buffers, which are flushed with one fetch_add
+on the shared size, so no filter pass over a padded array is needed either.
+*/
+
+const uint64_t FRONTIER_APPEND_BUFFER_SIZE = 256;
+
+/*
+The frontier becomes dense when it has more than nodes_count / FRONTIER_DENSE_RATIO nodes
+and sparse again when it has less than nodes_count / FRONTIER_SPARSE_RATIO nodes
+*/
+const uint64_t FRONTIER_DENSE_RATIO = 16;
+const uint64_t FRONTIER_SPARSE_RATIO = 64;
+
+struct bfs_frontier
+{
+public:
+    bfs_frontier(uint64_t nodes_count) :
+        _nodes_count(nodes_count),
+        _words_count((nodes_count + 63) / 64),
+        _cur_nodes(static_cast<long>(nodes_count)),
+        _next_nodes(static_cast<long>(nodes_count)),
+        _cur_bits(static_cast<long>(_words_count)),
+        _next_bits(static_cast<long>(_words_count)),
+        _size(0),
+        _next_size(0),
+        _dense(false)
+    {
+    }
+
+    void reset(uint64_t start_node)
+    {
+        assert(start_node < _nodes_count);
+        _cur_nodes[0] = start_node;
+        _size = 1;
+        _dense = false;
+    }
+
+    uint64_t size() const
+    {
+        return _size;
+    }
+
+    bool is_dense() const
+    {
+        return _dense;
+    }
+
+    bool contains(uint64_t node) const
+    {
+        assert(_dense);
+        return (_cur_bits[node / 64] >> (node % 64)) & 1;
+    }
+
+    /*
+    Replaces the frontier with the set of nodes to_node, for which visit(from_node, to_node)
+    returned true for some edge of the frontier. visit must return true at most once for every node.
+    */
+    template <typename Graph, typename Visit>
+    void advance(Graph const& edges, Visit const& visit)
+    {
+        _next_size = 0;
+        if (_dense)
+        {
+            clear_bits(_next_bits);
+            pasl::pctl::range::parallel_for(
+                static_cast<uint64_t>(0), _words_count,
+                [](uint64_t left, uint64_t right)
+                {
+                    return right - left;
+                },
+                [this, &edges, &visit](uint64_t word_idx)
+                {
+                    process_words(edges, visit, word_idx, word_idx + 1);
+                },
+                [this, &edges, &visit](uint64_t left, uint64_t right)
+                {
+                    process_words(edges, visit, left, right);
+                }
+            );
+            std::swap(_cur_bits, _next_bits);
+        }
+        else
+        {
+            pasl::pctl::range::parallel_for(
+                static_cast<uint64_t>(0), _size,
+                [](uint64_t left, uint64_t right)
+                {
+                    return right - left;
+                },
+                [this, &edges, &visit](uint64_t node_idx)
+                {
+                    process_nodes(edges, visit, node_idx, node_idx + 1);
+                },
+                [this, &edges, &visit](uint64_t left, uint64_t right)
+                {
+                    process_nodes(edges, visit, left, right);
+                }
+            );
+            std::swap(_cur_nodes, _next_nodes);
+        }
+        _size = _next_size;
+
+        if (!_dense && _size > _nodes_count / FRONTIER_DENSE_RATIO)
+        {
+            to_dense();
+        }
+        else if (_dense && _size < _nodes_count / FRONTIER_SPARSE_RATIO)
+        {
+            to_sparse();
+        }
+    }
+private:
+    /*
+    Collects new frontier nodes of one sequential piece of work
+    */
+    struct appender
+    {
+        appender(bfs_frontier& frontier) : _frontier(frontier),
+                                           _count(0)
+        {
+        }
+
+        void push(uint64_t node)
+        {
+            if (_frontier._dense)
+            {
+                __atomic_fetch_or(&_frontier._next_bits[node / 64], UINT64_C(1) << (node % 64), __ATOMIC_RELAXED);
+                ++_count;
+                return;
+            }
+            _buffer[_count++] = node;
+            if (_count == FRONTIER_APPEND_BUFFER_SIZE)
+            {
+                flush();
+            }
+        }
+
+        void flush()
+        {
+            if (_count == 0)
+            {
+                return;
+            }
+            uint64_t start_idx = __atomic_fetch_add(&_frontier._next_size, _count, __ATOMIC_RELAXED);
+            if (!_frontier._dense)
+            {
+                assert(start_idx + _count <= _frontier._nodes_count);
+                for (uint64_t i = 0; i < _count; ++i)
+                {
+                    _frontier._next_nodes[start_idx + i] = _buffer[i];
+                }
+            }
+            _count = 0;
+        }
+
+        ~appender()
+        {
+            flush();
+        }
+
+        bfs_frontier& _frontier;
+        uint64_t      _buffer[FRONTIER_APPEND_BUFFER_SIZE];
+        uint64_t      _count;
+    };
+
+    template <typename Graph, typename Visit>
+    void process_node(Graph const& edges, Visit const& visit, uint64_t from_node, appender& next)
+    {
+        for_each_neighbor(
+            edges, from_node,
+            [&visit, &next, from_node](uint64_t to_node)
+            {
+                if (visit(from_node, to_node))
+                {
+                    next.push(to_node);
+                }
+            }
+        );
+    }
+
+    template <typename Graph, typename Visit>
+    void process_nodes(Graph const& edges, Visit const& visit, uint64_t left, uint64_t right)
+    {
+        appender next(*this);
+        for (uint64_t node_idx = left; node_idx < right; ++node_idx)
+        {
+            process_node(edges, visit, _cur_nodes[node_idx], next);
+        }
+    }
+
+    template <typename Graph, typename Visit>
+    void process_words(Graph const& edges, Visit const& visit, uint64_t left, uint64_t right)
+    {
+        appender next(*this);
+        for (uint64_t word_idx = left; word_idx < right; ++word_idx)
+        {
+            uint64_t word = _cur_bits[word_idx];
+            while (word != 0)
+            {
+                process_node(edges, visit, word_idx * 64 + __builtin_ctzll(word), next);
+                word &= word - 1;
+            }
+        }
+    }
+
+    void clear_bits(pasl::pctl::parray<uint64_t>& bits)
+    {
+        pasl::pctl::parallel_for(
+            static_cast<uint64_t>(0), _words_count,
+            [&bits](uint64_t word_idx)
+            {
+                bits[word_idx] = 0;
+            }
+        );
+    }
+
+    void to_dense()
+    {
+        clear_bits(_cur_bits);
+        pasl::pctl::parallel_for(
+            static_cast<uint64_t>(0), _size,
+            [this](uint64_t node_idx)
+            {
+                uint64_t node = _cur_nodes[node_idx];
+                __atomic_fetch_or(&_cur_bits[node / 64], UINT64_C(1) << (node % 64), __ATOMIC_RELAXED);
+            }
+        );
+        _dense = true;
+    }
+
+    void to_sparse()
+    {
+        _dense = false;
+        _next_size = 0;
+        pasl::pctl::range::parallel_for(
+            static_cast<uint64_t>(0), _words_count,
+            [](uint64_t left, uint64_t right)
+            {
+                return right - left;
+            },
+            [this](uint64_t word_idx)
+            {
+                compact_words(word_idx, word_idx + 1);
+            },
+            [this](uint64_t left, uint64_t right)
+            {
+                compact_words(left, right);
+            }
+        );
+        assert(_next_size == _size);
+        std::swap(_cur_nodes, _next_nodes);
+    }
+
+    void compact_words(uint64_t left, uint64_t right)
+    {
+        appender next(*this);
+        for (uint64_t word_idx = left; word_idx < right; ++word_idx)
+        {
+            uint64_t word = _cur_bits[word_idx];
+            while (word != 0)
+            {
+                next.push(word_idx * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    uint64_t                     _nodes_count;
+    uint64_t                     _words_count;
+    pasl::pctl::parray<uint64_t> _cur_nodes;
+    pasl::pctl::parray<uint64_t> _next_nodes;
+    pasl::pctl::parray<uint64_t> _cur_bits;
+    pasl::pctl::parray<uint64_t> _next_bits;
+    uint64_t                     _size;
+    uint64_t                     _next_size;
+    bool                         _dense;
+};
+
+/*
+Frontier kept as per-worker lists: a worker appends new nodes to its own list without any synchronization,
+and the lists are never concatenated. The next level iterates over all lists through prefix sums of their sizes,
+which take O(workers) time, so a level costs one parallel loop and one barrier.
+Lists are cleared, not freed, so their memory is reused by the following levels and traversals.
+*/
+struct worker_frontier
+{
+public:
+    worker_frontier(uint64_t workers_count = static_cast<uint64_t>(__cilkrts_get_nworkers())) :
+        _cur(workers_count),
+        _next(workers_count),
+        _offsets(workers_count + 1, 0)
+    {
+        assert(workers_count > 0);
+    }
+
+    void reset(uint64_t start_node)
+    {
+        for (worker_list& list : _cur)
+        {
+            list.nodes.clear();
+        }
+        _cur[0].nodes.push_back(start_node);
+        update_offsets();
+    }
+
+    uint64_t size() const
+    {
+        return _offsets.back();
+    }
+
+    /*
+    Same contract as bfs_frontier::advance
+    */
+    template <typename Graph, typename Visit>
+    void advance(Graph const& edges, Visit const& visit)
+    {
+        pasl::pctl::range::parallel_for(
+            static_cast<uint64_t>(0), size(),
+            [](uint64_t left, uint64_t right)
+            {
+                return right - left;
+            },
+            [this, &edges, &visit](uint64_t node_idx)
+            {
+                process_nodes(edges, visit, node_idx, node_idx + 1);
+            },
+            [this, &edges, &visit](uint64_t left, uint64_t right)
+            {
+                process_nodes(edges, visit, left, right);
+            }
+        );
+        std::swap(_cur, _next);
+        for (worker_list& list : _next)
+        {
+            list.nodes.clear();
+        }
+        update_offsets();
+    }
+private:
+    // aligned, so that sizes of lists of different workers do not share cache lines
+    struct alignas(64) worker_list
+    {
+        std::vector<uint64_t> nodes;
+    };
+
+    void update_offsets()
+    {
+        for (uint64_t list_idx = 0; list_idx < _cur.size(); ++list_idx)
+        {
+            _offsets[list_idx + 1] = _offsets[list_idx] + _cur[list_idx].nodes.size();
+        }
+    }
+
+    /*
+    A sequential piece of work runs on one worker, which does not change until the piece ends
+    */
+    template <typename Graph, typename Visit>
+    void process_nodes(Graph const& edges, Visit const& visit, uint64_t left, uint64_t right)
+    {
+        uint64_t worker = static_cast<uint64_t>(__cilkrts_get_worker_number());
+        assert(worker < _next.size());
+        std::vector<uint64_t>& next_nodes = _next[worker].nodes;
+        uint64_t list_idx = std::upper_bound(_offsets.begin(), _offsets.end(), left) - _offsets.begin() - 1;
+        for (uint64_t node_idx = left; node_idx < right; ++node_idx)
+        {
+            while (node_idx >= _offsets[list_idx + 1])
+            {
+                ++list_idx;
+            }
+            uint64_t from_node = _cur[list_idx].nodes[node_idx - _offsets[list_idx]];
+            for_each_neighbor(
+                edges, from_node,
+                [&visit, &next_nodes, from_node](uint64_t to_node)
+                {
+                    if (visit(from_node, to_node))
+                    {
+                        next_nodes.push_back(to_node);
+                    }
+                }
+            );
+        }
+    }
+
+    std::vector<worker_list> _cur;
+    std::vector<worker_list> _next;
+    std::vector<uint64_t>    _offsets;
+};
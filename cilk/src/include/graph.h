@@ -0,0 +1,646 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+Graph access interface: every graph type provides node_degree, node_neighbor, for_each_neighbor,
+for_each_neighbor_until, for_each_neighbor_range and graph_memory_bytes. for_each_neighbor calls f(to_node)
+for all neighbors in the order of their indexes, for_each_neighbor_until stops at the first neighbor,
+for which f returned true, for_each_neighbor_range calls f(to_node) for neighbors with indexes in [first, last).
+Graph types override them when neighbors can be enumerated faster than by index.
+*/
+
+using adjacency_list = std::vector<std::vector<uint64_t>>;
+
+inline uint64_t node_degree(adjacency_list const& edges, uint64_t node)
+{
+    return static_cast<uint64_t>(edges[node].size());
+}
+
+inline uint64_t node_neighbor(adjacency_list const& edges, uint64_t node, uint64_t edge_idx)
+{
+    assert(edge_idx < edges[node].size());
+    return edges[node][edge_idx];
+}
+
+template <typename Graph, typename F>
+void for_each_neighbor(Graph const& edges, uint64_t node, F&& f)
+{
+    uint64_t degree = node_degree(edges, node);
+    for (uint64_t edge_idx = 0; edge_idx < degree; ++edge_idx)
+    {
+        f(node_neighbor(edges, node, edge_idx));
+    }
+}
+
+template <typename Graph, typename F>
+void for_each_neighbor_until(Graph const& edges, uint64_t node, F&& f)
+{
+    uint64_t degree = node_degree(edges, node);
+    for (uint64_t edge_idx = 0; edge_idx < degree; ++edge_idx)
+    {
+        if (f(node_neighbor(edges, node, edge_idx)))
+        {
+            return;
+        }
+    }
+}
+
+template <typename Graph, typename F>
+void for_each_neighbor_range(Graph const& edges, uint64_t node, uint64_t first, uint64_t last, F&& f)
+{
+    assert(first <= last && last <= node_degree(edges, node));
+    for (uint64_t edge_idx = first; edge_idx < last; ++edge_idx)
+    {
+        f(node_neighbor(edges, node, edge_idx));
+    }
+}
+
+/*
+Range enumeration for graphs, whose neighbors can only be enumerated sequentially:
+neighbors before first are skipped, so a range costs one pass over the list up to last
+*/
+template <typename Graph, typename F>
+void for_each_neighbor_range_sequential(Graph const& edges, uint64_t node, uint64_t first, uint64_t last, F&& f)
+{
+    assert(first <= last && last <= node_degree(edges, node));
+    if (first == last)
+    {
+        return;
+    }
+    uint64_t edge_idx = 0;
+    for_each_neighbor_until(
+        edges, node,
+        [&f, &edge_idx, first, last](uint64_t to_node)
+        {
+            if (edge_idx >= first)
+            {
+                f(to_node);
+            }
+            return ++edge_idx == last;
+        }
+    );
+}
+
+/*
+Whether node_neighbor takes constant time. Graphs, whose neighbors are decoded sequentially, specialize it
+as false, and parallel loops over a single list split it into blocks instead of single edges.
+*/
+template <typename Graph>
+struct has_indexed_neighbors : std::true_type
+{
+};
+
+inline uint64_t graph_memory_bytes(adjacency_list const& edges)
+{
+    uint64_t result = sizeof(adjacency_list) + edges.capacity() * sizeof(std::vector<uint64_t>);
+    for (std::vector<uint64_t> const& to_nodes : edges)
+    {
+        result += to_nodes.capacity() * sizeof(uint64_t);
+    }
+    return result;
+}
+
+/*
+Compressed sparse row graph: neighbors of node v are stored in edges[offsets[v]], ..., edges[offsets[v + 1] - 1].
+V is the type of vertex ids, uint32_t halves the size of the edges array for graphs with less than 2^32 vertices.
+*/
+
+template <typename V>
+struct csr_graph
+{
+public:
+    csr_graph(pasl::pctl::parray<uint64_t>&& offsets, pasl::pctl::parray<V>&& edges) :
+        _offsets(std::move(offsets)),
+        _edges(std::move(edges))
+    {
+        assert(_offsets.size() > 0);
+        assert(_offsets[_offsets.size() - 1] == static_cast<uint64_t>(_edges.size()));
+    }
+
+    uint64_t nodes_count() const
+    {
+        return static_cast<uint64_t>(_offsets.size() - 1);
+    }
+
+    uint64_t edges_count() const
+    {
+        return static_cast<uint64_t>(_edges.size());
+    }
+
+    uint64_t degree(uint64_t node) const
+    {
+        assert(node < nodes_count());
+        return _offsets[node + 1] - _offsets[node];
+    }
+
+    V neighbor(uint64_t node, uint64_t edge_idx) const
+    {
+        assert(edge_idx < degree(node));
+        return _edges[_offsets[node] + edge_idx];
+    }
+
+    pasl::pctl::parray<uint64_t> const& get_offsets() const
+    {
+        return _offsets;
+    }
+
+    pasl::pctl::parray<V> const& get_edges() const
+    {
+        return _edges;
+    }
+private:
+    pasl::pctl::parray<uint64_t> _offsets;
+    pasl::pctl::parray<V>        _edges;
+};
+
+template <typename V>
+uint64_t node_degree(csr_graph<V> const& graph, uint64_t node)
+{
+    return graph.degree(node);
+}
+
+template <typename V>
+uint64_t node_neighbor(csr_graph<V> const& graph, uint64_t node, uint64_t edge_idx)
+{
+    return static_cast<uint64_t>(graph.neighbor(node, edge_idx));
+}
+
+template <typename V, typename F>
+void for_each_neighbor(csr_graph<V> const& graph, uint64_t node, F&& f)
+{
+    pasl::pctl::parray<uint64_t> const& offsets = graph.get_offsets();
+    pasl::pctl::parray<V> const& edges = graph.get_edges();
+    for (uint64_t i = offsets[node]; i < offsets[node + 1]; ++i)
+    {
+        f(static_cast<uint64_t>(edges[i]));
+    }
+}
+
+template <typename V, typename F>
+void for_each_neighbor_until(csr_graph<V> const& graph, uint64_t node, F&& f)
+{
+    pasl::pctl::parray<uint64_t> const& offsets = graph.get_offsets();
+    pasl::pctl::parray<V> const& edges = graph.get_edges();
+    for (uint64_t i = offsets[node]; i < offsets[node + 1]; ++i)
+    {
+        if (f(static_cast<uint64_t>(edges[i])))
+        {
+            return;
+        }
+    }
+}
+
+template <typename V, typename F>
+void for_each_neighbor_range(csr_graph<V> const& graph, uint64_t node, uint64_t first, uint64_t last, F&& f)
+{
+    assert(first <= last && last <= graph.degree(node));
+    pasl::pctl::parray<V> const& edges = graph.get_edges();
+    uint64_t first_edge = graph.get_offsets()[node];
+    for (uint64_t i = first_edge + first; i < first_edge + last; ++i)
+    {
+        f(static_cast<uint64_t>(edges[i]));
+    }
+}
+
+template <typename V>
+uint64_t graph_memory_bytes(csr_graph<V> const& graph)
+{
+    return sizeof(csr_graph<V>) +
+        (graph.nodes_count() + 1) * sizeof(uint64_t) +
+        graph.edges_count() * sizeof(V);
+}
+
+/*
+Builds CSR offsets (of size degrees.size() + 1) from node degrees
+*/
+inline pasl::pctl::parray<uint64_t> degrees_to_offsets(pasl::pctl::parray<uint64_t> const& degrees)
+{
+    long nodes_count = degrees.size();
+    pasl::pctl::parray<uint64_t> pref_degrees = pasl::pctl::scan(
+        degrees.begin(), degrees.end(), static_cast<uint64_t>(0),
+        [](uint64_t x, uint64_t y)
+        {
+            return x + y;
+        },
+        pasl::pctl::scan_type::forward_exclusive_scan
+    );
+    uint64_t edges_count = 0;
+    if (nodes_count > 0)
+    {
+        edges_count = pref_degrees[nodes_count - 1] + degrees[nodes_count - 1];
+    }
+    return pasl::pctl::parray<uint64_t>(
+        nodes_count + 1,
+        [&pref_degrees, nodes_count, edges_count](long node)
+        {
+            if (node == nodes_count)
+            {
+                return edges_count;
+            }
+            return pref_degrees[node];
+        }
+    );
+}
+
+uint64_t const COUNTING_SORT_BLOCK_SIZE = 1 << 14;
+uint64_t const COUNTING_SORT_RADIX = 1 << 11;
+uint64_t const COUNTING_SORT_MIN_BLOCKS = 64;
+
+/*
+One pass of the blocked counting sort. for_items(left, right, f) must call f(key, item) for items [left, right)
+in order, keys are from [0, keys_count). Every block of items counts its keys, the counts are scanned
+in (key, block) order, so every block knows the position of its first item of every key, and then every block
+calls place(position, item) for its items in order. No atomics are needed and the order is stable.
+Counts take blocks * keys_count memory, so there are at most items_count / keys_count blocks.
+Returns offsets of keys (of size keys_count + 1).
+*/
+template <typename ForItems, typename Place>
+pasl::pctl::parray<uint64_t> counting_sort_pass(
+    uint64_t items_count, uint64_t keys_count, ForItems const& for_items, Place const& place)
+{
+    uint64_t blocks_count = std::max(
+        static_cast<uint64_t>(1),
+        std::min(
+            (items_count + COUNTING_SORT_BLOCK_SIZE - 1) / COUNTING_SORT_BLOCK_SIZE,
+            items_count / std::max(keys_count, static_cast<uint64_t>(1))
+        )
+    );
+    uint64_t block_size = (items_count + blocks_count - 1) / blocks_count;
+    auto for_block_items = [&for_items, items_count, block_size](uint64_t block, auto const& f)
+    {
+        uint64_t left = std::min(items_count, block * block_size);
+        for_items(left, std::min(items_count, left + block_size), f);
+    };
+
+    pasl::pctl::parray<uint64_t> counts(static_cast<long>(blocks_count * keys_count), static_cast<uint64_t>(0));
+    pasl::pctl::parallel_for(
+        static_cast<uint64_t>(0), blocks_count,
+        [&for_block_items, &counts, keys_count](uint64_t block)
+        {
+            uint64_t* block_counts = counts.begin() + block * keys_count;
+            for_block_items(
+                block,
+                [block_counts](uint64_t key, auto const&)
+                {
+                    ++block_counts[key];
+                }
+            );
+        }
+    );
+    pasl::pctl::parray<uint64_t> key_offsets = degrees_to_offsets(
+        pasl::pctl::parray<uint64_t>(
+            static_cast<long>(keys_count),
+            [&counts, blocks_count, keys_count](long key)
+            {
+                uint64_t result = 0;
+                for (uint64_t block = 0; block < blocks_count; ++block)
+                {
+                    result += counts[block * keys_count + key];
+                }
+                return result;
+            }
+        )
+    );
+    // counts become positions of the first items of every (block, key)
+    pasl::pctl::parallel_for(
+        static_cast<uint64_t>(0), keys_count,
+        [&counts, &key_offsets, blocks_count, keys_count](uint64_t key)
+        {
+            uint64_t position = key_offsets[key];
+            for (uint64_t block = 0; block < blocks_count; ++block)
+            {
+                uint64_t count = counts[block * keys_count + key];
+                counts[block * keys_count + key] = position;
+                position += count;
+            }
+        }
+    );
+    pasl::pctl::parallel_for(
+        static_cast<uint64_t>(0), blocks_count,
+        [&for_block_items, &counts, &place, keys_count](uint64_t block)
+        {
+            uint64_t* block_positions = counts.begin() + block * keys_count;
+            for_block_items(
+                block,
+                [block_positions, &place](uint64_t key, auto const& item)
+                {
+                    place(block_positions[key]++, item);
+                }
+            );
+        }
+    );
+    return key_offsets;
+}
+
+/*
+Stable parallel counting sort: items, given by for_items like in counting_sort_pass, are sorted by their keys
+from [0, keys_count) into values. Returns offsets of keys (of size keys_count + 1).
+When there are many keys and few items per key, one pass would have few blocks, so items are sorted
+by the high bits of their keys first and then every range of equal high bits is sorted by the low bits,
+in parallel over the ranges. This costs a temporary copy of the items and of the low bits of their keys.
+*/
+template <typename T, typename ForItems>
+pasl::pctl::parray<uint64_t> counting_sort(
+    uint64_t items_count, uint64_t keys_count, ForItems const& for_items, pasl::pctl::parray<T>& values)
+{
+    values = pasl::pctl::parray<T>(static_cast<long>(items_count));
+    if (keys_count <= COUNTING_SORT_RADIX || items_count / keys_count >= COUNTING_SORT_MIN_BLOCKS)
+    {
+        return counting_sort_pass(
+            items_count, keys_count, for_items,
+            [&values](uint64_t position, T const& value)
+            {
+                values[position] = value;
+            }
+        );
+    }
+
+    uint32_t low_bits = 0;
+    while (((keys_count - 1) >> low_bits) >= COUNTING_SORT_RADIX)
+    {
+        ++low_bits;
+    }
+    assert(low_bits <= 32);
+    uint64_t low_mask = (static_cast<uint64_t>(1) << low_bits) - 1;
+    uint64_t high_count = ((keys_count - 1) >> low_bits) + 1;
+    pasl::pctl::parray<uint32_t> low_keys(static_cast<long>(items_count));
+    pasl::pctl::parray<T> high_sorted(static_cast<long>(items_count));
+    pasl::pctl::parray<uint64_t> high_offsets = counting_sort_pass(
+        items_count, high_count,
+        [&for_items, low_bits, low_mask](uint64_t left, uint64_t right, auto const& f)
+        {
+            for_items(
+                left, right,
+                [&f, low_bits, low_mask](uint64_t key, T const& value)
+                {
+                    f(key >> low_bits, std::make_pair(static_cast<uint32_t>(key & low_mask), value));
+                }
+            );
+        },
+        [&low_keys, &high_sorted](uint64_t position, std::pair<uint32_t, T> const& item)
+        {
+            low_keys[position] = item.first;
+            high_sorted[position] = item.second;
+        }
+    );
+
+    pasl::pctl::parray<uint64_t> offsets(static_cast<long>(keys_count + 1));
+    offsets[keys_count] = items_count;
+    pasl::pctl::parallel_for(
+        static_cast<uint64_t>(0), high_count,
+        [&high_offsets](uint64_t high_key)
+        {
+            return high_offsets[high_key + 1] - high_offsets[high_key] + 1;
+        },
+        [&low_keys, &high_sorted, &high_offsets, &values, &offsets, keys_count, low_bits](uint64_t high_key)
+        {
+            uint64_t first = high_offsets[high_key];
+            uint64_t first_key = high_key << low_bits;
+            uint64_t span = std::min(keys_count, first_key + (static_cast<uint64_t>(1) << low_bits)) - first_key;
+            pasl::pctl::parray<uint64_t> low_offsets = counting_sort_pass(
+                high_offsets[high_key + 1] - first, span,
+                [&low_keys, &high_sorted, first](uint64_t left, uint64_t right, auto const& f)
+                {
+                    for (uint64_t idx = first + left; idx < first + right; ++idx)
+                    {
+                        f(static_cast<uint64_t>(low_keys[idx]), high_sorted[idx]);
+                    }
+                },
+                [&values, first](uint64_t position, T const& value)
+                {
+                    values[first + position] = value;
+                }
+            );
+            for (uint64_t key = 0; key < span; ++key)
+            {
+                offsets[first_key + key] = first + low_offsets[key];
+            }
+        }
+    );
+    return offsets;
+}
+
+template <typename V>
+csr_graph<V> adjacency_list_to_csr(adjacency_list const& edges)
+{
+    long nodes_count = static_cast<long>(edges.size());
+    pasl::pctl::parray<uint64_t> offsets = degrees_to_offsets(
+        pasl::pctl::parray<uint64_t>(
+            nodes_count,
+            [&edges](long node)
+            {
+                return static_cast<uint64_t>(edges[node].size());
+            }
+        )
+    );
+
+    pasl::pctl::parray<V> csr_edges(static_cast<long>(offsets[nodes_count]));
+    pasl::pctl::parallel_for(
+        static_cast<uint64_t>(0), static_cast<uint64_t>(nodes_count),
+        [&edges, &offsets, &csr_edges](uint64_t node)
+        {
+            std::vector<uint64_t> const& to_nodes = edges[node];
+            for (uint64_t edge_idx = 0; edge_idx < to_nodes.size(); ++edge_idx)
+            {
+                assert(static_cast<uint64_t>(static_cast<V>(to_nodes[edge_idx])) == to_nodes[edge_idx]);
+                csr_edges[offsets[node] + edge_idx] = static_cast<V>(to_nodes[edge_idx]);
+            }
+        }
+    );
+    return csr_graph<V>(std::move(offsets), std::move(csr_edges));
+}
+
+/*
+Edge list: edge i goes from from[i] to to[i]
+*/
+
+struct csr_build_options
+{
+    bool symmetrize        = false;
+    bool remove_duplicates = false;
+    bool remove_self_loops = false;
+};
+
+struct edge_list
+{
+    uint64_t                     nodes_count;
+    pasl::pctl::parray<uint64_t> from;
+    pasl::pctl::parray<uint64_t> to;
+};
+
+/*
+CSR construction from a set of edges: for_edges(left, right, f) must call f(from_node, to_node) for edges
+with indexes [left, right) in order, options.symmetrize is ignored. Edges are placed by counting_sort
+by their sources, so there are no atomics, the result is deterministic and every list keeps the order
+of edge indexes. Lists are sorted only when they are not sorted already (the transpose of a graph
+with sorted lists is sorted), duplicates and self-loops are removed from the sorted lists.
+*/
+template <typename V, typename ForEdges>
+csr_graph<V> build_csr(
+    long nodes_count, uint64_t edges_count, ForEdges const& for_edges, csr_build_options const& options)
+{
+    pasl::pctl::parray<V> csr_edges;
+    pasl::pctl::parray<uint64_t> offsets = counting_sort(
+        edges_count, static_cast<uint64_t>(nodes_count),
+        [&for_edges](uint64_t left, uint64_t right, auto const& f)
+        {
+            for_edges(
+                left, right,
+                [&f](uint64_t from_node, uint64_t to_node)
+                {
+                    f(from_node, static_cast<V>(to_node));
+                }
+            );
+        },
+        csr_edges
+    );
+
+    bool compact = options.remove_duplicates || options.remove_self_loops;
+    pasl::pctl::parray<uint64_t> degrees(compact ? nodes_count : 0);
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes_count,
+        [&offsets](long node)
+        {
+            return offsets[node + 1] - offsets[node] + 1;
+        },
+        [&offsets, &csr_edges, &degrees, &options, compact](long node)
+        {
+            V* begin = csr_edges.begin() + offsets[node];
+            V* end = csr_edges.begin() + offsets[node + 1];
+            if (!std::is_sorted(begin, end))
+            {
+                std::sort(begin, end);
+            }
+            if (!compact)
+            {
+                return;
+            }
+            if (options.remove_self_loops)
+            {
+                end = std::remove(begin, end, static_cast<V>(node));
+            }
+            if (options.remove_duplicates)
+            {
+                end = std::unique(begin, end);
+            }
+            degrees[node] = static_cast<uint64_t>(end - begin);
+        }
+    );
+    if (!compact)
+    {
+        return csr_graph<V>(std::move(offsets), std::move(csr_edges));
+    }
+
+    pasl::pctl::parray<uint64_t> compact_offsets = degrees_to_offsets(degrees);
+    pasl::pctl::parray<V> compact_edges(static_cast<long>(compact_offsets[nodes_count]));
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes_count,
+        [&offsets](long node)
+        {
+            return offsets[node + 1] - offsets[node] + 1;
+        },
+        [&offsets, &csr_edges, &degrees, &compact_offsets, &compact_edges](long node)
+        {
+            std::copy(
+                csr_edges.begin() + offsets[node], csr_edges.begin() + offsets[node] + degrees[node],
+                compact_edges.begin() + compact_offsets[node]
+            );
+        }
+    );
+    return csr_graph<V>(std::move(compact_offsets), std::move(compact_edges));
+}
+
+/*
+CSR construction from an edge list, with options.symmetrize every edge is added in both directions
+*/
+template <typename V>
+csr_graph<V> edge_list_to_csr(edge_list const& edges, csr_build_options const& options)
+{
+    if (edges.nodes_count > 0 && edges.nodes_count - 1 > std::numeric_limits<V>::max())
+    {
+        throw std::runtime_error("vertex ids do not fit into the vertex id type");
+    }
+    uint64_t input_edges_count = static_cast<uint64_t>(edges.from.size());
+    auto for_edges = [&edges, input_edges_count](uint64_t left, uint64_t right, auto const& f)
+    {
+        for (uint64_t edge_idx = left; edge_idx < right; ++edge_idx)
+        {
+            if (edge_idx < input_edges_count)
+            {
+                f(edges.from[edge_idx], edges.to[edge_idx]);
+            }
+            else
+            {
+                f(edges.to[edge_idx - input_edges_count], edges.from[edge_idx - input_edges_count]);
+            }
+        }
+    };
+    uint64_t edges_count = options.symmetrize ? 2 * input_edges_count : input_edges_count;
+    return build_csr<V>(static_cast<long>(edges.nodes_count), edges_count, for_edges, options);
+}
+
+/*
+Transpose of the graph, built like a CSR from an edge list: edges are enumerated in the order of the graph,
+so lists of the transpose are sorted without sorting. With options.symmetrize the result has every edge
+in both directions, which is the undirected form of the graph.
+*/
+template <typename V>
+csr_graph<V> transpose_graph(csr_graph<V> const& graph, csr_build_options const& options)
+{
+    uint64_t edges_count = graph.edges_count();
+    pasl::pctl::parray<uint64_t> const& offsets = graph.get_offsets();
+    pasl::pctl::parray<V> const& to_nodes = graph.get_edges();
+    auto for_graph_edges = [&offsets, &to_nodes](uint64_t left, uint64_t right, auto const& f)
+    {
+        // the source of edge left is the last node, whose edges do not start after it
+        uint64_t from_node = static_cast<uint64_t>(
+            std::upper_bound(offsets.begin(), offsets.end(), left) - offsets.begin() - 1
+        );
+        for (uint64_t edge_idx = left; edge_idx < right; ++edge_idx)
+        {
+            while (offsets[from_node + 1] <= edge_idx)
+            {
+                ++from_node;
+            }
+            f(from_node, static_cast<uint64_t>(to_nodes[edge_idx]));
+        }
+    };
+    auto for_edges = [&for_graph_edges, edges_count](uint64_t left, uint64_t right, auto const& f)
+    {
+        for_graph_edges(
+            std::min(left, edges_count), std::min(right, edges_count),
+            [&f](uint64_t from_node, uint64_t to_node)
+            {
+                f(to_node, from_node);
+            }
+        );
+        if (right > edges_count)
+        {
+            for_graph_edges(std::max(left, edges_count) - edges_count, right - edges_count, f);
+        }
+    };
+    return build_csr<V>(
+        static_cast<long>(graph.nodes_count()), options.symmetrize ? 2 * edges_count : edges_count, for_edges, options
+    );
+}
+
+/*
+Undirected form of the graph. Edges, which are present in both directions, become duplicates,
+so options.remove_duplicates is usually set.
+*/
+template <typename V>
+csr_graph<V> symmetrize_graph(csr_graph<V> const& graph, csr_build_options options)
+{
+    options.symmetrize = true;
+    return transpose_graph(graph, options);
+}
@@ -1,13 +1,17 @@
 #pragma once
 
+#include "graph.h"
 #include <array>
 #include <vector>
 #include <cstdint>
 #include <cassert>
 #include <iostream>
+#include <utility>
+#include <algorithm>
+#include <optional>
 
 template <std::size_t DIM>
-uint64_t coords_to_index(std::array<uint64_t, DIM> const& coords, std::array<uint64_t, DIM> const& dimensions)
+std::array<uint64_t, DIM> calc_elems_in_dim(std::array<uint64_t, DIM> const& dimensions)
 {
     static_assert(DIM >= 1);
 
@@ -17,6 +21,15 @@ uint64_t coords_to_index(std::array<uint64_t, DIM> const& coords, std::array<uin
     {
         elems_in_dim[i - 1] = elems_in_dim[i] * dimensions[i];
     }
+    return elems_in_dim;
+}
+
+template <std::size_t DIM>
+uint64_t coords_to_index(std::array<uint64_t, DIM> const& coords, std::array<uint64_t, DIM> const& dimensions)
+{
+    static_assert(DIM >= 1);
+
+    std::array<uint64_t, DIM> elems_in_dim = calc_elems_in_dim(dimensions);
 
     uint64_t result = 0;
     for (std::size_t i = 0; i < DIM; ++i)
@@ -81,4 +94,589 @@ std::vector<std::vector<uint64_t>> build_graph(std::array<uint64_t, DIM> const&
     std::array<uint64_t, DIM> coords;
     do_build_graph(edges, dimensions, coords, 0);
     return edges;
-}
\ No newline at end of file
+}
+
+template <std::size_t DIM>
+std::array<uint64_t, DIM> index_to_coords(
+    uint64_t index, [[maybe_unused]] std::array<uint64_t, DIM> const& dimensions,
+    std::array<uint64_t, DIM> const& elems_in_dim)
+{
+    std::array<uint64_t, DIM> coords;
+    for (std::size_t i = 0; i < DIM; ++i)
+    {
+        coords[i] = index / elems_in_dim[i];
+        index %= elems_in_dim[i];
+        assert(coords[i] < dimensions[i]);
+    }
+    return coords;
+}
+
+template <std::size_t DIM>
+uint64_t calc_grid_degree(std::array<uint64_t, DIM> const& coords, std::array<uint64_t, DIM> const& dimensions)
+{
+    uint64_t result = 0;
+    for (std::size_t i = 0; i < DIM; ++i)
+    {
+        if (coords[i] > 0)
+        {
+            ++result;
+        }
+        if (coords[i] + 1 < dimensions[i])
+        {
+            ++result;
+        }
+    }
+    return result;
+}
+
+/*
+Calls f(to_node) for all neighbors of the grid node in ascending order
+*/
+template <std::size_t DIM, typename F>
+void for_each_grid_neighbor(
+    uint64_t node, std::array<uint64_t, DIM> const& coords,
+    std::array<uint64_t, DIM> const& dimensions, std::array<uint64_t, DIM> const& elems_in_dim, F&& f)
+{
+    for (std::size_t i = 0; i < DIM; ++i)
+    {
+        if (coords[i] > 0)
+        {
+            f(node - elems_in_dim[i]);
+        }
+    }
+    for (std::size_t i = DIM; i >= 1; --i)
+    {
+        if (coords[i - 1] + 1 < dimensions[i - 1])
+        {
+            f(node + elems_in_dim[i - 1]);
+        }
+    }
+}
+
+/*
+Morton (Z-order) layout: coordinate bits are interleaved from the most significant level down,
+dimensions with fewer bits drop out of the lower levels, so every dimension owns a fixed mask of code bits
+and its coordinate is deposited into (extracted from) the mask like with pdep (pext).
+Unless all dimensions are powers of two, the codes of the grid points have gaps, so a point's index is the rank
+of its code among the codes of all grid points, which keeps indexes dense. Ranks are answered by a bitmap
+of valid codes with a prefix count per word (2 bits per code), and codes of indexes by a binary search
+of the counts between sampled words, so neighbors are found by masked increments of the code and one rank each.
+*/
+template <std::size_t DIM>
+struct morton_layout
+{
+public:
+    morton_layout(std::array<uint64_t, DIM> const& dimensions) : _masks(),
+                                                                _max_codes(),
+                                                                _dense(true)
+    {
+        std::array<uint32_t, DIM> bits;
+        uint32_t max_bits = 0;
+        uint32_t total_bits = 0;
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            assert(dimensions[i] > 0);
+            bits[i] = 0;
+            while ((UINT64_C(1) << bits[i]) < dimensions[i])
+            {
+                ++bits[i];
+            }
+            _dense = _dense && (UINT64_C(1) << bits[i]) == dimensions[i];
+            max_bits = std::max(max_bits, bits[i]);
+            total_bits += bits[i];
+        }
+        assert(total_bits < 64);
+
+        uint32_t bit_idx = 0;
+        for (uint32_t level = 1; level <= max_bits; ++level)
+        {
+            for (std::size_t i = DIM; i >= 1; --i)
+            {
+                if (bits[i - 1] >= level)
+                {
+                    _masks[i - 1] |= UINT64_C(1) << bit_idx;
+                    ++bit_idx;
+                }
+            }
+        }
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            _max_codes[i] = deposit(dimensions[i] - 1, _masks[i]);
+        }
+        if (!_dense)
+        {
+            build_ranks(total_bits, calc_nodes_count(dimensions));
+        }
+    }
+
+    uint64_t coords_to_index(std::array<uint64_t, DIM> const& coords) const
+    {
+        uint64_t code = 0;
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            code |= deposit(coords[i], _masks[i]);
+            assert((code & _masks[i]) <= _max_codes[i]);
+        }
+        return rank(code);
+    }
+
+    std::array<uint64_t, DIM> index_to_coords(uint64_t index) const
+    {
+        uint64_t code = select(index);
+        std::array<uint64_t, DIM> coords;
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            coords[i] = extract(code, _masks[i]);
+        }
+        return coords;
+    }
+
+    uint64_t degree(uint64_t index) const
+    {
+        uint64_t code = select(index);
+        uint64_t result = 0;
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            uint64_t coord_code = code & _masks[i];
+            result += (coord_code > 0) + (coord_code < _max_codes[i]);
+        }
+        return result;
+    }
+
+    /*
+    Calls f(to_node) for all neighbors of the node in ascending order: ranks keep the order of codes,
+    so the codes are sorted before they are ranked
+    */
+    template <typename F>
+    void for_each_neighbor(uint64_t index, F&& f) const
+    {
+        uint64_t code = select(index);
+        // missing neighbors stay UINT64_MAX, so the whole array is sorted and they go last
+        std::array<uint64_t, 2 * DIM> to_codes;
+        to_codes.fill(UINT64_MAX);
+        std::size_t degree = 0;
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            uint64_t coord_code = code & _masks[i];
+            uint64_t other_code = code & ~_masks[i];
+            if (coord_code > 0)
+            {
+                to_codes[degree++] = other_code | ((coord_code - 1) & _masks[i]);
+            }
+            if (coord_code < _max_codes[i])
+            {
+                to_codes[degree++] = other_code | (((code | ~_masks[i]) + 1) & _masks[i]);
+            }
+        }
+        std::sort(to_codes.begin(), to_codes.end());
+        for (std::size_t i = 0; i < degree; ++i)
+        {
+            f(rank(to_codes[i]));
+        }
+    }
+private:
+    static uint64_t deposit(uint64_t value, uint64_t mask)
+    {
+        uint64_t result = 0;
+        for (uint64_t bit = 1; mask != 0; bit <<= 1)
+        {
+            if ((value & bit) != 0)
+            {
+                result |= mask & (~mask + 1);
+            }
+            mask &= mask - 1;
+        }
+        return result;
+    }
+
+    static uint64_t extract(uint64_t code, uint64_t mask)
+    {
+        uint64_t result = 0;
+        for (uint64_t bit = 1; mask != 0; bit <<= 1)
+        {
+            if ((code & mask & (~mask + 1)) != 0)
+            {
+                result |= bit;
+            }
+            mask &= mask - 1;
+        }
+        return result;
+    }
+
+    /*
+    Position of the set bit with the given number (from 0) in the word
+    */
+    static uint64_t select_bit(uint64_t word, uint64_t number)
+    {
+        assert(number < static_cast<uint64_t>(__builtin_popcountll(word)));
+        uint64_t shift = 0;
+        while (true)
+        {
+            uint64_t byte_count = static_cast<uint64_t>(__builtin_popcountll(word & 0xff));
+            if (number < byte_count)
+            {
+                break;
+            }
+            number -= byte_count;
+            word >>= 8;
+            shift += 8;
+        }
+        for (; number > 0; --number)
+        {
+            word &= word - 1;
+        }
+        return shift + static_cast<uint64_t>(__builtin_ctzll(word));
+    }
+
+    void build_ranks(uint32_t total_bits, uint64_t nodes_count)
+    {
+        uint64_t codes_count = UINT64_C(1) << total_bits;
+        uint64_t words_count = (codes_count + 63) / 64;
+        _words = pasl::pctl::parray<uint64_t>(
+            static_cast<long>(words_count),
+            [this, codes_count](long word_idx)
+            {
+                uint64_t word = 0;
+                uint64_t first_code = static_cast<uint64_t>(word_idx) * 64;
+                for (uint64_t code = first_code; code < first_code + 64 && code < codes_count; ++code)
+                {
+                    bool valid = true;
+                    for (std::size_t i = 0; i < DIM; ++i)
+                    {
+                        valid = valid && (code & _masks[i]) <= _max_codes[i];
+                    }
+                    word |= static_cast<uint64_t>(valid) << (code - first_code);
+                }
+                return word;
+            }
+        );
+        _ranks = degrees_to_offsets(
+            pasl::pctl::parray<uint64_t>(
+                static_cast<long>(words_count),
+                [this](long word_idx)
+                {
+                    return static_cast<uint64_t>(__builtin_popcountll(_words[word_idx]));
+                }
+            )
+        );
+        assert(_ranks[words_count] == nodes_count);
+        _sample_words = pasl::pctl::parray<uint64_t>(
+            static_cast<long>((nodes_count + 63) / 64),
+            [this, words_count](long sample)
+            {
+                uint64_t const* ranks = _ranks.cbegin();
+                return static_cast<uint64_t>(
+                    std::upper_bound(ranks, ranks + words_count, static_cast<uint64_t>(sample) * 64) - ranks - 1
+                );
+            }
+        );
+    }
+
+    uint64_t rank(uint64_t code) const
+    {
+        if (_dense)
+        {
+            return code;
+        }
+        uint64_t word_idx = code / 64;
+        uint64_t below = _words[word_idx] & ((UINT64_C(1) << (code % 64)) - 1);
+        return _ranks[word_idx] + static_cast<uint64_t>(__builtin_popcountll(below));
+    }
+
+    uint64_t select(uint64_t index) const
+    {
+        if (_dense)
+        {
+            return index;
+        }
+        uint64_t sample = index / 64;
+        uint64_t first = _sample_words[sample];
+        uint64_t last = static_cast<uint64_t>(_words.size());
+        if (sample + 1 < static_cast<uint64_t>(_sample_words.size()))
+        {
+            last = _sample_words[sample + 1] + 1;
+        }
+        uint64_t const* ranks = _ranks.cbegin();
+        uint64_t word_idx = static_cast<uint64_t>(std::upper_bound(ranks + first, ranks + last, index) - ranks - 1);
+        return word_idx * 64 + select_bit(_words[word_idx], index - _ranks[word_idx]);
+    }
+
+    std::array<uint64_t, DIM>    _masks;
+    std::array<uint64_t, DIM>    _max_codes;
+    bool                         _dense;
+    pasl::pctl::parray<uint64_t> _words;
+    pasl::pctl::parray<uint64_t> _ranks;
+    pasl::pctl::parray<uint64_t> _sample_words;
+};
+
+enum struct GridLayout
+{
+    RowMajor,
+    Morton
+};
+
+/*
+Mapping between grid coordinates and node indexes in the chosen layout
+*/
+template <std::size_t DIM>
+struct grid_indexer
+{
+public:
+    grid_indexer(std::array<uint64_t, DIM> const& dimensions, GridLayout layout) :
+        _dimensions(dimensions),
+        _elems_in_dim(calc_elems_in_dim(dimensions)),
+        _layout(layout)
+    {
+        if (layout == GridLayout::Morton)
+        {
+            _morton.emplace(dimensions);
+        }
+    }
+
+    uint64_t nodes_count() const
+    {
+        return calc_nodes_count(_dimensions);
+    }
+
+    uint64_t coords_to_index(std::array<uint64_t, DIM> const& coords) const
+    {
+        if (_layout == GridLayout::Morton)
+        {
+            return _morton->coords_to_index(coords);
+        }
+        uint64_t result = 0;
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            assert(coords[i] < _dimensions[i]);
+            result += coords[i] * _elems_in_dim[i];
+        }
+        return result;
+    }
+
+    std::array<uint64_t, DIM> index_to_coords(uint64_t index) const
+    {
+        assert(index < nodes_count());
+        if (_layout == GridLayout::Morton)
+        {
+            return _morton->index_to_coords(index);
+        }
+        return ::index_to_coords(index, _dimensions, _elems_in_dim);
+    }
+
+    uint64_t degree(uint64_t node) const
+    {
+        if (_layout == GridLayout::Morton)
+        {
+            return _morton->degree(node);
+        }
+        return calc_grid_degree(index_to_coords(node), _dimensions);
+    }
+
+    /*
+    Calls f(to_node) for all neighbors of the node in ascending order
+    */
+    template <typename F>
+    void for_each_neighbor(uint64_t node, F&& f) const
+    {
+        if (_layout == GridLayout::Morton)
+        {
+            _morton->for_each_neighbor(node, f);
+            return;
+        }
+        for_each_grid_neighbor(node, index_to_coords(node), _dimensions, _elems_in_dim, f);
+    }
+
+    std::array<uint64_t, DIM> const& get_dimensions() const
+    {
+        return _dimensions;
+    }
+
+    GridLayout get_layout() const
+    {
+        return _layout;
+    }
+private:
+    std::array<uint64_t, DIM>         _dimensions;
+    std::array<uint64_t, DIM>         _elems_in_dim;
+    GridLayout                        _layout;
+    std::optional<morton_layout<DIM>> _morton;
+};
+
+/*
+Index of every row-major node in the given layout, computed in parallel
+*/
+template <std::size_t DIM>
+pasl::pctl::parray<uint64_t> row_major_to_layout(std::array<uint64_t, DIM> const& dimensions, GridLayout layout)
+{
+    grid_indexer<DIM> row_major(dimensions, GridLayout::RowMajor);
+    grid_indexer<DIM> indexer(dimensions, layout);
+    return pasl::pctl::parray<uint64_t>(
+        static_cast<long>(calc_nodes_count(dimensions)),
+        [&row_major, &indexer](long node)
+        {
+            return indexer.coords_to_index(row_major.index_to_coords(node));
+        }
+    );
+}
+
+/*
+Parallel construction of the grid graph in CSR layout: degrees are computed from coordinates,
+offsets are built with a parallel scan and every node writes its sorted neighbors independently
+*/
+template <typename V, std::size_t DIM>
+csr_graph<V> build_csr_graph(std::array<uint64_t, DIM> const& dimensions, GridLayout layout = GridLayout::RowMajor)
+{
+    grid_indexer<DIM> indexer(dimensions, layout);
+    uint64_t nodes_count = indexer.nodes_count();
+
+    pasl::pctl::parray<uint64_t> offsets = degrees_to_offsets(
+        pasl::pctl::parray<uint64_t>(
+            static_cast<long>(nodes_count),
+            [&indexer](long node)
+            {
+                return indexer.degree(node);
+            }
+        )
+    );
+
+    pasl::pctl::parray<V> edges(static_cast<long>(offsets[nodes_count]));
+    pasl::pctl::parallel_for(
+        static_cast<uint64_t>(0), nodes_count,
+        [&indexer, &offsets, &edges](uint64_t node)
+        {
+            uint64_t edge_idx = offsets[node];
+            indexer.for_each_neighbor(
+                node,
+                [&edges, &edge_idx](uint64_t to_node)
+                {
+                    edges[edge_idx++] = static_cast<V>(to_node);
+                }
+            );
+            assert(edge_idx == offsets[node + 1]);
+        }
+    );
+    return csr_graph<V>(std::move(offsets), std::move(edges));
+}
+
+/*
+Implicit grid graph: nothing but the dimensions and strides is stored,
+neighbors are computed from coordinates on every access in the same order as in build_csr_graph
+*/
+template <std::size_t DIM>
+struct grid_graph
+{
+public:
+    grid_graph(std::array<uint64_t, DIM> const& dimensions, GridLayout layout = GridLayout::RowMajor) :
+        _indexer(dimensions, layout)
+    {
+    }
+
+    uint64_t nodes_count() const
+    {
+        return _indexer.nodes_count();
+    }
+
+    uint64_t edges_count() const
+    {
+        std::array<uint64_t, DIM> const& dimensions = _indexer.get_dimensions();
+        uint64_t result = 0;
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            result += 2 * (dimensions[i] - 1) * (nodes_count() / dimensions[i]);
+        }
+        return result;
+    }
+
+    uint64_t degree(uint64_t node) const
+    {
+        assert(node < nodes_count());
+        return _indexer.degree(node);
+    }
+
+    uint64_t neighbor(uint64_t node, uint64_t edge_idx) const
+    {
+        assert(edge_idx < degree(node));
+        uint64_t result = 0;
+        uint64_t cur_idx = 0;
+        for_each_neighbor_until(
+            node,
+            [&result, &cur_idx, edge_idx](uint64_t to_node)
+            {
+                result = to_node;
+                return cur_idx++ == edge_idx;
+            }
+        );
+        return result;
+    }
+
+    template <typename F>
+    void for_each_neighbor(uint64_t node, F&& f) const
+    {
+        assert(node < nodes_count());
+        _indexer.for_each_neighbor(node, f);
+    }
+
+    /*
+    Neighbors are computed together, so the ones after the stop are only skipped, which is O(DIM) per call
+    */
+    template <typename F>
+    void for_each_neighbor_until(uint64_t node, F&& f) const
+    {
+        bool stopped = false;
+        for_each_neighbor(
+            node,
+            [&f, &stopped](uint64_t to_node)
+            {
+                stopped = stopped || f(to_node);
+            }
+        );
+    }
+
+    std::array<uint64_t, DIM> coords(uint64_t node) const
+    {
+        return _indexer.index_to_coords(node);
+    }
+
+    std::array<uint64_t, DIM> const& get_dimensions() const
+    {
+        return _indexer.get_dimensions();
+    }
+private:
+    grid_indexer<DIM> _indexer;
+};
+
+template <std::size_t DIM>
+uint64_t node_degree(grid_graph<DIM> const& graph, uint64_t node)
+{
+    return graph.degree(node);
+}
+
+template <std::size_t DIM>
+uint64_t node_neighbor(grid_graph<DIM> const& graph, uint64_t node, uint64_t edge_idx)
+{
+    return graph.neighbor(node, edge_idx);
+}
+
+template <std::size_t DIM, typename F>
+void for_each_neighbor(grid_graph<DIM> const& graph, uint64_t node, F&& f)
+{
+    graph.for_each_neighbor(node, f);
+}
+
+template <std::size_t DIM, typename F>
+void for_each_neighbor_until(grid_graph<DIM> const& graph, uint64_t node, F&& f)
+{
+    graph.for_each_neighbor_until(node, f);
+}
+
+template <std::size_t DIM, typename F>
+void for_each_neighbor_range(grid_graph<DIM> const& graph, uint64_t node, uint64_t first, uint64_t last, F&& f)
+{
+    for_each_neighbor_range_sequential(graph, node, first, last, f);
+}
+
+template <std::size_t DIM>
+uint64_t graph_memory_bytes(grid_graph<DIM> const&)
+{
+    return sizeof(grid_graph<DIM>);
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include <cstdint>
+#include <cassert>
+
+/*
+Parallel synthetic graph generators. All randomness comes from a counter-based hash of (seed, counters),
+so every edge is generated independently and the result depends only on the seed, not on scheduling.
+All generated graphs are undirected: they are symmetrized, duplicate edges and self-loops are removed.
+*/
+
+inline uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t random_hash(uint64_t seed, uint64_t idx, uint64_t sub_idx = 0)
+{
+    return splitmix64(splitmix64(splitmix64(seed) ^ idx) ^ sub_idx);
+}
+
+/*
+Uniform in [0, 1)
+*/
+inline double random_unit(uint64_t seed, uint64_t idx, uint64_t sub_idx = 0)
+{
+    return static_cast<double>(random_hash(seed, idx, sub_idx) >> 11) * (1.0 / (UINT64_C(1) << 53));
+}
+
+/*
+Random permutation of [0, n): a bijection of [0, 2^k) built from xor-shifts and odd multipliers
+is applied until the value falls into [0, n) (cycle walking)
+*/
+inline uint64_t random_permutation(uint64_t idx, uint64_t n, uint64_t seed)
+{
+    assert(idx < n);
+    uint32_t bits = 1;
+    while ((UINT64_C(1) << bits) < n)
+    {
+        ++bits;
+    }
+    uint64_t mask = (bits == 64) ? UINT64_MAX : (UINT64_C(1) << bits) - 1;
+    uint32_t shift = (bits + 1) / 2;
+
+    uint64_t result = idx;
+    do
+    {
+        for (uint64_t round = 0; round < 3; ++round)
+        {
+            result = (result ^ (random_hash(seed, round) & mask)) & mask;
+            result = (result * (random_hash(seed, round, 1) | 1)) & mask;
+            result ^= result >> shift;
+        }
+    }
+    while (result >= n);
+    return result;
+}
+
+template <typename V>
+csr_graph<V> undirected_edge_list_to_csr(edge_list const& edges)
+{
+    csr_build_options options;
+    options.symmetrize = true;
+    options.remove_duplicates = true;
+    options.remove_self_loops = true;
+    return edge_list_to_csr<V>(edges, options);
+}
+
+/*
+R-MAT (Kronecker) graph with 2^scale nodes and edge_factor * 2^scale generated edges. Every edge descends
+scale levels of the adjacency matrix choosing a quadrant with probabilities a, b, c and 1 - a - b - c.
+Defaults are the Graph500 parameters. Node ids are randomly permuted, as in Graph500,
+so that high degree nodes are not clustered at small ids.
+*/
+template <typename V>
+csr_graph<V> generate_rmat_graph(
+    uint32_t scale, uint64_t edge_factor, uint64_t seed,
+    double a = 0.57, double b = 0.19, double c = 0.19)
+{
+    assert(scale < 64);
+    assert(a + b + c <= 1.0);
+    uint64_t nodes_count = UINT64_C(1) << scale;
+    long edges_count = static_cast<long>(edge_factor * nodes_count);
+    uint64_t permutation_seed = random_hash(seed, UINT64_MAX);
+
+    edge_list edges = {
+        nodes_count, pasl::pctl::parray<uint64_t>(edges_count), pasl::pctl::parray<uint64_t>(edges_count)
+    };
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), edges_count,
+        [&edges, scale, seed, a, b, c, nodes_count, permutation_seed](long edge_idx)
+        {
+            uint64_t from_node = 0;
+            uint64_t to_node = 0;
+            for (uint32_t level = 0; level < scale; ++level)
+            {
+                double p = random_unit(seed, edge_idx, level);
+                uint64_t row_bit = (p >= a + b) ? 1 : 0;
+                uint64_t col_bit = (p >= a && p < a + b) || p >= a + b + c ? 1 : 0;
+                from_node = (from_node << 1) | row_bit;
+                to_node = (to_node << 1) | col_bit;
+            }
+            edges.from[edge_idx] = random_permutation(from_node, nodes_count, permutation_seed);
+            edges.to[edge_idx] = random_permutation(to_node, nodes_count, permutation_seed);
+        }
+    );
+    return undirected_edge_list_to_csr<V>(edges);
+}
+
+/*
+Erdős–Rényi G(n, m) graph with m = nodes_count * avg_degree / 2 uniformly random edges
+*/
+template <typename V>
+csr_graph<V> generate_uniform_graph(uint64_t nodes_count, uint64_t avg_degree, uint64_t seed)
+{
+    assert(nodes_count > 0);
+    long edges_count = static_cast<long>(nodes_count * avg_degree / 2);
+    edge_list edges = {
+        nodes_count, pasl::pctl::parray<uint64_t>(edges_count), pasl::pctl::parray<uint64_t>(edges_count)
+    };
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), edges_count,
+        [&edges, nodes_count, seed](long edge_idx)
+        {
+            edges.from[edge_idx] = random_hash(seed, edge_idx, 0) % nodes_count;
+            edges.to[edge_idx] = random_hash(seed, edge_idx, 1) % nodes_count;
+        }
+    );
+    return undirected_edge_list_to_csr<V>(edges);
+}
+
+/*
+Random regular graph as the union of degree / 2 random permutations: node v is connected to p_k(v)
+for every permutation p_k. Self-loops and repeated edges are dropped, so a few nodes
+(about degree^2 / 2 in expectation) end up with a smaller degree.
+*/
+template <typename V>
+csr_graph<V> generate_regular_graph(uint64_t nodes_count, uint64_t degree, uint64_t seed)
+{
+    assert(nodes_count > 0);
+    assert(degree % 2 == 0);
+    uint64_t permutations_count = degree / 2;
+    long edges_count = static_cast<long>(nodes_count * permutations_count);
+    edge_list edges = {
+        nodes_count, pasl::pctl::parray<uint64_t>(edges_count), pasl::pctl::parray<uint64_t>(edges_count)
+    };
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), edges_count,
+        [&edges, nodes_count, seed](long edge_idx)
+        {
+            uint64_t permutation_idx = edge_idx / nodes_count;
+            uint64_t from_node = edge_idx % nodes_count;
+            edges.from[edge_idx] = from_node;
+            edges.to[edge_idx] = random_permutation(from_node, nodes_count, random_hash(seed, permutation_idx));
+        }
+    );
+    return undirected_edge_list_to_csr<V>(edges);
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+Parallel graph loading. Text input is mapped into memory, split into chunks along line boundaries
+and every chunk is parsed independently: the first pass counts edges, the second one writes them
+to positions given by a scan over the counts.
+*/
+
+const uint64_t PARSE_CHUNK_SIZE = 1 << 20;
+
+/*
+Text parsing
+*/
+
+inline bool is_blank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/*
+Returns false if there is no number or it does not fit into uint64_t
+*/
+inline bool parse_uint(char const*& pos, char const* end, uint64_t& value)
+{
+    while (pos < end && is_blank(*pos))
+    {
+        ++pos;
+    }
+    if (pos == end || *pos < '0' || *pos > '9')
+    {
+        return false;
+    }
+    value = 0;
+    while (pos < end && '0' <= *pos && *pos <= '9')
+    {
+        if (__builtin_mul_overflow(value, 10, &value) ||
+            __builtin_add_overflow(value, static_cast<uint64_t>(*pos - '0'), &value))
+        {
+            return false;
+        }
+        ++pos;
+    }
+    return true;
+}
+
+/*
+Calls on_edge(from, to) for every line of [begin, end), lines starting with '#' or '%' and empty lines are skipped,
+everything after the first two numbers of a line is ignored. Ids are shifted down by first_id.
+Returns false if the chunk contains a malformed line or an id, for which nodes_count would overflow.
+*/
+template <typename F>
+bool parse_edges_chunk(char const* begin, char const* end, uint64_t first_id, F&& on_edge)
+{
+    char const* pos = begin;
+    while (pos < end)
+    {
+        char const* line_end = static_cast<char const*>(std::memchr(pos, '\n', end - pos));
+        if (line_end == nullptr)
+        {
+            line_end = end;
+        }
+
+        char const* first = pos;
+        while (first < line_end && is_blank(*first))
+        {
+            ++first;
+        }
+        if (first < line_end && *first != '#' && *first != '%')
+        {
+            uint64_t from_node = 0;
+            uint64_t to_node = 0;
+            if (!parse_uint(first, line_end, from_node) || !parse_uint(first, line_end, to_node) ||
+                from_node < first_id || to_node < first_id ||
+                from_node - first_id == UINT64_MAX || to_node - first_id == UINT64_MAX)
+            {
+                return false;
+            }
+            on_edge(from_node - first_id, to_node - first_id);
+        }
+        pos = line_end + 1;
+    }
+    return true;
+}
+
+/*
+Parses edges of [begin, end) in parallel, nodes_count is one more than the largest id
+*/
+inline edge_list parse_edges(char const* begin, char const* end, uint64_t first_id, std::string const& path)
+{
+    uint64_t bytes_count = static_cast<uint64_t>(end - begin);
+    long chunks_count = static_cast<long>(std::max<uint64_t>(1, bytes_count / PARSE_CHUNK_SIZE));
+
+    pasl::pctl::parray<char const*> chunk_starts(
+        chunks_count + 1,
+        [begin, end, bytes_count, chunks_count](long chunk_idx)
+        {
+            if (chunk_idx == 0)
+            {
+                return begin;
+            }
+            if (chunk_idx == chunks_count)
+            {
+                return end;
+            }
+            char const* pos = begin + bytes_count / chunks_count * chunk_idx;
+            char const* line_end = static_cast<char const*>(std::memchr(pos, '\n', end - pos));
+            return line_end == nullptr ? end : line_end + 1;
+        }
+    );
+
+    pasl::pctl::parray<uint64_t> chunk_sizes(chunks_count, static_cast<uint64_t>(0));
+    pasl::pctl::parray<uint64_t> chunk_max_ids(chunks_count, static_cast<uint64_t>(0));
+    pasl::pctl::parray<int> chunk_errors(chunks_count, 0);
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), chunks_count,
+        [&chunk_starts, &chunk_sizes, &chunk_max_ids, &chunk_errors, first_id](long chunk_idx)
+        {
+            uint64_t edges_count = 0;
+            uint64_t max_id = 0;
+            bool parsed = parse_edges_chunk(
+                chunk_starts[chunk_idx], chunk_starts[chunk_idx + 1], first_id,
+                [&edges_count, &max_id](uint64_t from_node, uint64_t to_node)
+                {
+                    ++edges_count;
+                    max_id = std::max(max_id, std::max(from_node, to_node) + 1);
+                }
+            );
+            chunk_sizes[chunk_idx] = edges_count;
+            chunk_max_ids[chunk_idx] = max_id;
+            chunk_errors[chunk_idx] = parsed ? 0 : 1;
+        }
+    );
+
+    uint64_t nodes_count = 0;
+    for (long chunk_idx = 0; chunk_idx < chunks_count; ++chunk_idx)
+    {
+        if (chunk_errors[chunk_idx] != 0)
+        {
+            throw std::runtime_error("malformed edge in " + path);
+        }
+        nodes_count = std::max(nodes_count, chunk_max_ids[chunk_idx]);
+    }
+
+    pasl::pctl::parray<uint64_t> chunk_offsets = degrees_to_offsets(chunk_sizes);
+    long edges_count = static_cast<long>(chunk_offsets[chunks_count]);
+    edge_list result = {
+        nodes_count, pasl::pctl::parray<uint64_t>(edges_count), pasl::pctl::parray<uint64_t>(edges_count)
+    };
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), chunks_count,
+        [&chunk_starts, &chunk_offsets, &result, first_id](long chunk_idx)
+        {
+            uint64_t edge_idx = chunk_offsets[chunk_idx];
+            parse_edges_chunk(
+                chunk_starts[chunk_idx], chunk_starts[chunk_idx + 1], first_id,
+                [&result, &edge_idx](uint64_t from_node, uint64_t to_node)
+                {
+                    result.from[edge_idx] = from_node;
+                    result.to[edge_idx] = to_node;
+                    ++edge_idx;
+                }
+            );
+            assert(edge_idx == chunk_offsets[chunk_idx + 1]);
+        }
+    );
+    return result;
+}
+
+/*
+Whitespace separated edge list (SNAP format): "from to" per line, ids start from 0
+*/
+inline edge_list read_edge_list(std::string const& path)
+{
+    mapped_file file(path, MapMode::ReadOnly, true, MADV_SEQUENTIAL);
+    char const* begin = static_cast<char const*>(file.data());
+    return parse_edges(begin, begin + file.size(), 0, path);
+}
+
+/*
+Matrix Market coordinate format, ids start from 1. Symmetric matrices store only one triangle,
+so reading one sets symmetric to true.
+*/
+inline edge_list read_matrix_market(std::string const& path, bool& symmetric)
+{
+    mapped_file file(path, MapMode::ReadOnly, true, MADV_SEQUENTIAL);
+    if (file.size() == 0)
+    {
+        throw std::runtime_error(path + " is empty");
+    }
+    char const* pos = static_cast<char const*>(file.data());
+    char const* end = pos + file.size();
+
+    auto next_line = [&pos, end]()
+    {
+        char const* line_end = static_cast<char const*>(std::memchr(pos, '\n', end - pos));
+        std::string line(pos, line_end == nullptr ? end : line_end);
+        pos = line_end == nullptr ? end : line_end + 1;
+        return line;
+    };
+
+    std::istringstream banner(next_line());
+    std::string header, object, format, field, symmetry;
+    banner >> header >> object >> format >> field >> symmetry;
+    if (header != "%%MatrixMarket" || object != "matrix" || format != "coordinate")
+    {
+        throw std::runtime_error(path + " is not a Matrix Market coordinate matrix");
+    }
+    symmetric = (symmetry != "general");
+
+    std::string size_line;
+    do
+    {
+        if (pos == end)
+        {
+            throw std::runtime_error("missing size line in " + path);
+        }
+        size_line = next_line();
+    }
+    while (size_line.empty() || size_line[0] == '%');
+
+    uint64_t rows = 0;
+    uint64_t cols = 0;
+    uint64_t nonzeros = 0;
+    std::istringstream sizes(size_line);
+    if (!(sizes >> rows >> cols >> nonzeros))
+    {
+        throw std::runtime_error("malformed size line in " + path);
+    }
+
+    edge_list result = parse_edges(pos, end, 1, path);
+    if (static_cast<uint64_t>(result.from.size()) != nonzeros || result.nodes_count > std::max(rows, cols))
+    {
+        throw std::runtime_error("entries of " + path + " do not match its size line");
+    }
+    result.nodes_count = std::max(rows, cols);
+    return result;
+}
+
+template <typename V>
+csr_graph<V> load_edge_list(std::string const& path, csr_build_options const& options)
+{
+    return edge_list_to_csr<V>(read_edge_list(path), options);
+}
+
+template <typename V>
+csr_graph<V> load_matrix_market(std::string const& path, csr_build_options options)
+{
+    bool symmetric = false;
+    edge_list edges = read_matrix_market(path, symmetric);
+    options.symmetrize = options.symmetrize || symmetric;
+    return edge_list_to_csr<V>(edges, options);
+}
+
+/*
+Binary CSR: header, nodes_count + 1 offsets of 8 bytes and edges_count vertex ids of vertex_size bytes
+*/
+
+const uint64_t CSR_FILE_MAGIC = 0x31305253435f4150; // "PA_CSR01"
+
+struct csr_file_header
+{
+    uint64_t magic;
+    uint64_t vertex_size;
+    uint64_t nodes_count;
+    uint64_t edges_count;
+};
+
+template <typename V>
+void save_csr_binary(std::string const& path, csr_graph<V> const& graph)
+{
+    csr_file_header header = {CSR_FILE_MAGIC, sizeof(V), graph.nodes_count(), graph.edges_count()};
+    write_file(
+        path,
+        {
+            {&header, sizeof(header)},
+            {graph.get_offsets().begin(), (graph.nodes_count() + 1) * sizeof(uint64_t)},
+            {graph.get_edges().begin(), graph.edges_count() * sizeof(V)}
+        }
+    );
+}
+
+inline csr_file_header read_csr_header(mapped_file const& file, std::string const& path)
+{
+    csr_file_header header;
+    if (file.size() < sizeof(header))
+    {
+        throw std::runtime_error(path + " is too small for a CSR file");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    // counts come from the file, so the expected size is computed with overflow checks
+    uint64_t offsets_size = 0;
+    uint64_t edges_size = 0;
+    uint64_t expected_size = 0;
+    if (header.magic != CSR_FILE_MAGIC ||
+        __builtin_add_overflow(header.nodes_count, 1, &offsets_size) ||
+        __builtin_mul_overflow(offsets_size, sizeof(uint64_t), &offsets_size) ||
+        __builtin_mul_overflow(header.edges_count, header.vertex_size, &edges_size) ||
+        __builtin_add_overflow(offsets_size, edges_size, &expected_size) ||
+        __builtin_add_overflow(expected_size, sizeof(header), &expected_size) ||
+        file.size() != expected_size)
+    {
+        throw std::runtime_error(path + " is not a valid CSR file");
+    }
+    return header;
+}
+
+/*
+Size of vertex ids stored in the file, lets the caller choose the vertex id type before loading
+*/
+inline uint64_t csr_binary_vertex_size(std::string const& path)
+{
+    mapped_file file(path, MapMode::ReadOnly, false, MADV_NORMAL);
+    return read_csr_header(file, path).vertex_size;
+}
+
+template <typename V>
+csr_graph<V> load_csr_binary(std::string const& path)
+{
+    mapped_file file(path, MapMode::ReadOnly, true, MADV_SEQUENTIAL);
+    csr_file_header header = read_csr_header(file, path);
+    if (header.vertex_size != sizeof(V))
+    {
+        throw std::runtime_error(path + " stores vertex ids of a different size");
+    }
+
+    uint64_t const* file_offsets = reinterpret_cast<uint64_t const*>(
+        static_cast<char const*>(file.data()) + sizeof(header)
+    );
+    V const* file_edges = reinterpret_cast<V const*>(file_offsets + header.nodes_count + 1);
+    if (file_offsets[0] != 0 || file_offsets[header.nodes_count] != header.edges_count)
+    {
+        throw std::runtime_error(path + " is not a valid CSR file");
+    }
+
+    // offsets must not decrease and vertex ids must be less than nodes_count, otherwise traversals
+    // would read out of bounds, so both are checked while copying
+    uint64_t nodes_count = header.nodes_count;
+    bool invalid = false;
+    pasl::pctl::parray<uint64_t> offsets(
+        static_cast<long>(nodes_count + 1),
+        [file_offsets, nodes_count, &invalid](long idx)
+        {
+            if (static_cast<uint64_t>(idx) < nodes_count && file_offsets[idx] > file_offsets[idx + 1])
+            {
+                __atomic_store_n(&invalid, true, __ATOMIC_RELAXED);
+            }
+            return file_offsets[idx];
+        }
+    );
+    pasl::pctl::parray<V> edges(
+        static_cast<long>(header.edges_count),
+        [file_edges, nodes_count, &invalid](long idx)
+        {
+            if (static_cast<uint64_t>(file_edges[idx]) >= nodes_count)
+            {
+                __atomic_store_n(&invalid, true, __ATOMIC_RELAXED);
+            }
+            return file_edges[idx];
+        }
+    );
+    if (invalid)
+    {
+        throw std::runtime_error(path + " is not a valid CSR file");
+    }
+    return csr_graph<V>(std::move(offsets), std::move(edges));
+}
@@ -0,0 +1,335 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include "bfs.h"
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/*
+Vertex reordering: an order is a permutation new_to_old of the nodes, the relabeled graph has
+node v in place of node new_to_old[v]. Orders place nodes that are accessed together close to each other,
+so BFS touches result and edges in a less scattered pattern.
+*/
+
+enum struct VertexOrder
+{
+    Degree,
+    Bfs,
+    ReverseCuthillMcKee,
+    GorderLite
+};
+
+template <typename V>
+struct reordered_graph
+{
+    csr_graph<V>                 graph;
+    pasl::pctl::parray<uint64_t> new_to_old;
+    pasl::pctl::parray<uint64_t> old_to_new;
+};
+
+inline pasl::pctl::parray<uint64_t> invert_permutation(pasl::pctl::parray<uint64_t> const& permutation)
+{
+    long nodes_count = permutation.size();
+    pasl::pctl::parray<uint64_t> result(nodes_count);
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes_count,
+        [&permutation, &result](long idx)
+        {
+            result[permutation[idx]] = static_cast<uint64_t>(idx);
+        }
+    );
+    return result;
+}
+
+/*
+Node ids sorted by keys from [0, keys_count), nodes with equal keys are ordered by id (see counting_sort)
+*/
+inline pasl::pctl::parray<uint64_t> order_by_key(pasl::pctl::parray<uint64_t> const& keys, uint64_t keys_count)
+{
+    pasl::pctl::parray<uint64_t> result;
+    counting_sort(
+        static_cast<uint64_t>(keys.size()), keys_count,
+        [&keys](uint64_t left, uint64_t right, auto const& f)
+        {
+            for (uint64_t node = left; node < right; ++node)
+            {
+                f(keys[node], node);
+            }
+        },
+        result
+    );
+    return result;
+}
+
+template <typename V>
+uint64_t max_degree(csr_graph<V> const& graph)
+{
+    long nodes_count = static_cast<long>(graph.nodes_count());
+    pasl::pctl::parray<uint64_t> degrees(
+        nodes_count,
+        [&graph](long node)
+        {
+            return graph.degree(node);
+        }
+    );
+    return pasl::pctl::reduce(
+        degrees.begin(), degrees.end(), static_cast<uint64_t>(0),
+        [](uint64_t x, uint64_t y)
+        {
+            return std::max(x, y);
+        }
+    );
+}
+
+/*
+Nodes by degree in descending order, hubs get the smallest ids
+*/
+template <typename V>
+pasl::pctl::parray<uint64_t> degree_order(csr_graph<V> const& graph)
+{
+    uint64_t degree_bound = max_degree(graph) + 1;
+    return order_by_key(
+        pasl::pctl::parray<uint64_t>(
+            static_cast<long>(graph.nodes_count()),
+            [&graph, degree_bound](long node)
+            {
+                return degree_bound - 1 - graph.degree(node);
+            }
+        ),
+        degree_bound
+    );
+}
+
+/*
+Nodes by BFS level from start_node, nodes of a level are ordered by id. Unreachable nodes go last.
+*/
+template <typename V>
+pasl::pctl::parray<uint64_t> bfs_order(csr_graph<V> const& graph, uint64_t start_node)
+{
+    uint64_t nodes_count = graph.nodes_count();
+    pasl::pctl::parray<int64_t> dists = bfs_cas(nodes_count, start_node, graph, NodeLoopType::Range, false);
+    return order_by_key(
+        pasl::pctl::parray<uint64_t>(
+            static_cast<long>(nodes_count),
+            [&dists, nodes_count](long node)
+            {
+                return dists[node] >= 0 ? static_cast<uint64_t>(dists[node]) : nodes_count;
+            }
+        ),
+        nodes_count + 1
+    );
+}
+
+/*
+Reverse Cuthill-McKee. Every connected component is traversed by BFS from its node of the minimal degree,
+neighbors are visited in the order of increasing degree, the resulting order is reversed.
+The traversal is inherently sequential, the relabeling itself is parallel.
+*/
+template <typename V>
+pasl::pctl::parray<uint64_t> rcm_order(csr_graph<V> const& graph)
+{
+    uint64_t nodes_count = graph.nodes_count();
+    pasl::pctl::parray<uint64_t> by_degree = degree_order(graph);
+    std::vector<bool> visited(nodes_count, false);
+    std::vector<uint64_t> order;
+    order.reserve(nodes_count);
+    std::vector<uint64_t> to_nodes;
+
+    for (uint64_t i = nodes_count; i > 0; --i)
+    {
+        uint64_t component_start = by_degree[i - 1];
+        if (visited[component_start])
+        {
+            continue;
+        }
+        visited[component_start] = true;
+        uint64_t head = order.size();
+        order.push_back(component_start);
+        while (head < order.size())
+        {
+            uint64_t from_node = order[head++];
+            to_nodes.clear();
+            for_each_neighbor(
+                graph, from_node,
+                [&visited, &to_nodes](uint64_t to_node)
+                {
+                    if (!visited[to_node])
+                    {
+                        visited[to_node] = true;
+                        to_nodes.push_back(to_node);
+                    }
+                }
+            );
+            std::sort(
+                to_nodes.begin(), to_nodes.end(),
+                [&graph](uint64_t x, uint64_t y)
+                {
+                    return std::make_pair(graph.degree(x), x) < std::make_pair(graph.degree(y), y);
+                }
+            );
+            order.insert(order.end(), to_nodes.begin(), to_nodes.end());
+        }
+    }
+    assert(order.size() == nodes_count);
+    return pasl::pctl::parray<uint64_t>(
+        static_cast<long>(nodes_count),
+        [&order, nodes_count](long idx)
+        {
+            return order[nodes_count - 1 - idx];
+        }
+    );
+}
+
+/*
+Simplified Gorder: nodes are placed greedily, the next node is the one with most edges
+to the last window_size placed nodes (Gorder also counts common in-neighbors, which costs
+the sum of squared degrees and is skipped here). When no unplaced node is adjacent to the window,
+the unplaced node of the largest degree is taken. Sequential.
+*/
+template <typename V>
+pasl::pctl::parray<uint64_t> gorder_lite_order(csr_graph<V> const& graph, uint64_t window_size = 5)
+{
+    uint64_t nodes_count = graph.nodes_count();
+    pasl::pctl::parray<uint64_t> by_degree = degree_order(graph);
+    std::vector<bool> placed(nodes_count, false);
+    std::vector<uint64_t> scores(nodes_count, 0);
+    std::priority_queue<std::pair<uint64_t, uint64_t>> candidates;
+    std::vector<uint64_t> order;
+    order.reserve(nodes_count);
+    uint64_t next_by_degree = 0;
+
+    auto update_scores = [&graph, &placed, &scores, &candidates](uint64_t node, bool entering)
+    {
+        for_each_neighbor(
+            graph, node,
+            [&placed, &scores, &candidates, entering](uint64_t to_node)
+            {
+                if (placed[to_node])
+                {
+                    return;
+                }
+                if (entering)
+                {
+                    ++scores[to_node];
+                }
+                else
+                {
+                    --scores[to_node];
+                }
+                if (scores[to_node] > 0)
+                {
+                    candidates.push({scores[to_node], to_node});
+                }
+            }
+        );
+    };
+
+    while (order.size() < nodes_count)
+    {
+        uint64_t next_node = nodes_count;
+        while (!candidates.empty())
+        {
+            auto [score, node] = candidates.top();
+            candidates.pop();
+            // entries are never updated in place, so stale ones are skipped
+            if (!placed[node] && score == scores[node] && score > 0)
+            {
+                next_node = node;
+                break;
+            }
+        }
+        if (next_node == nodes_count)
+        {
+            while (placed[by_degree[next_by_degree]])
+            {
+                ++next_by_degree;
+            }
+            next_node = by_degree[next_by_degree];
+        }
+
+        placed[next_node] = true;
+        order.push_back(next_node);
+        update_scores(next_node, true);
+        if (order.size() > window_size)
+        {
+            update_scores(order[order.size() - 1 - window_size], false);
+        }
+    }
+    return pasl::pctl::parray<uint64_t>(
+        static_cast<long>(nodes_count),
+        [&order](long idx)
+        {
+            return order[idx];
+        }
+    );
+}
+
+/*
+Parallel relabeling: node v of the result is node new_to_old[v] of the graph, neighbor lists are sorted
+*/
+template <typename V>
+reordered_graph<V> relabel_graph(csr_graph<V> const& graph, pasl::pctl::parray<uint64_t>&& new_to_old)
+{
+    long nodes_count = static_cast<long>(graph.nodes_count());
+    assert(new_to_old.size() == nodes_count);
+    pasl::pctl::parray<uint64_t> old_to_new = invert_permutation(new_to_old);
+
+    pasl::pctl::parray<uint64_t> offsets = degrees_to_offsets(
+        pasl::pctl::parray<uint64_t>(
+            nodes_count,
+            [&graph, &new_to_old](long node)
+            {
+                return graph.degree(new_to_old[node]);
+            }
+        )
+    );
+    pasl::pctl::parray<V> edges(static_cast<long>(offsets[nodes_count]));
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes_count,
+        [&offsets](long node)
+        {
+            return offsets[node + 1] - offsets[node] + 1;
+        },
+        [&graph, &new_to_old, &old_to_new, &offsets, &edges](long node)
+        {
+            uint64_t edge_idx = offsets[node];
+            for_each_neighbor(
+                graph, new_to_old[node],
+                [&old_to_new, &edges, &edge_idx](uint64_t to_node)
+                {
+                    edges[edge_idx++] = static_cast<V>(old_to_new[to_node]);
+                }
+            );
+            std::sort(edges.begin() + offsets[node], edges.begin() + edge_idx);
+        }
+    );
+    return {csr_graph<V>(std::move(offsets), std::move(edges)), std::move(new_to_old), std::move(old_to_new)};
+}
+
+template <typename V>
+pasl::pctl::parray<uint64_t> vertex_order(csr_graph<V> const& graph, VertexOrder order, uint64_t start_node = 0)
+{
+    switch (order)
+    {
+        case VertexOrder::Degree:
+            return degree_order(graph);
+        case VertexOrder::Bfs:
+            return bfs_order(graph, start_node);
+        case VertexOrder::ReverseCuthillMcKee:
+            return rcm_order(graph);
+        default:
+            return gorder_lite_order(graph);
+    }
+}
+
+template <typename V>
+reordered_graph<V> reorder_graph(csr_graph<V> const& graph, VertexOrder order, uint64_t start_node = 0)
+{
+    return relabel_graph(graph, vertex_order(graph, order, start_node));
+}
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "raw_array.h"
+#include "array_view.h"
 #include <cilk/cilk.h>
 #include <cilk/cilk_api.h>
 #include <functional>
 #include <cstdint>
+#include <new>
 
 template <typename F, typename T>
-raw_array<T> map_parallel(raw_array<F> const& from, std::function<T(F const&)> mapper, uint32_t blocks_count)
+raw_array<T> map_parallel(array_view<F const> from, std::function<T(F const&)> mapper, uint32_t blocks_count)
 {
     if (from.size() == 0)
     {
@@ -20,7 +22,7 @@ raw_array<T> map_parallel(raw_array<F> const& from, std::function<T(F const&)> m
         ++elements_per_block;
     }
 
-    raw_array<T> result(from.size());
+    raw_array<T> result = raw_array<T>::uninitialized(from.size());
 
     #pragma grainsize 1
     cilk_for (uint32_t i = 0; i < blocks_count; ++i)
@@ -33,7 +35,7 @@ raw_array<T> map_parallel(raw_array<F> const& from, std::function<T(F const&)> m
         }
         for (uint32_t j = left; j < right; ++j)
         {
-            result[j] = mapper(from[j]);
+            new (result.get_raw_ptr() + j) T(mapper(from[j]));
         }
     }
     return result;
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cilk/cilk.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum struct MapMode
+{
+    ReadOnly,
+    CopyOnWrite
+};
+
+const uint64_t FILE_COPY_BLOCK_SIZE = 1 << 22;
+
+[[noreturn]] inline void throw_file_error(std::string const& action, std::string const& path)
+{
+    throw std::system_error(errno, std::generic_category(), action + " " + path);
+}
+
+/*
+Owns a mapping of a whole file. ReadOnly mappings are shared and must not be written to,
+CopyOnWrite mappings are private: writes are visible only to this process and never reach the file.
+*/
+
+struct mapped_file
+{
+public:
+    mapped_file(std::string const& path, MapMode mode, bool populate, int advice) : _ptr(nullptr),
+                                                                                     _size(0)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw_file_error("open", path);
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0)
+        {
+            close(fd);
+            throw_file_error("stat", path);
+        }
+        _size = static_cast<uint64_t>(file_stat.st_size);
+        if (_size == 0)
+        {
+            close(fd);
+            return;
+        }
+
+        int prot = PROT_READ;
+        int flags = MAP_SHARED;
+        if (mode == MapMode::CopyOnWrite)
+        {
+            prot |= PROT_WRITE;
+            flags = MAP_PRIVATE;
+        }
+        if (populate)
+        {
+            flags |= MAP_POPULATE;
+        }
+        void* ptr = mmap(nullptr, _size, prot, flags, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED)
+        {
+            throw_file_error("mmap", path);
+        }
+        _ptr = ptr;
+        // the advice is only a hint, so failing to apply it is not an error
+        madvise(_ptr, _size, advice);
+    }
+
+    mapped_file(mapped_file const& other) = delete;
+
+    mapped_file(mapped_file&& other) noexcept : _ptr(other._ptr),
+                                                _size(other._size)
+    {
+        other._ptr = nullptr;
+        other._size = 0;
+    }
+
+    void const* data() const
+    {
+        return _ptr;
+    }
+
+    void* data()
+    {
+        return _ptr;
+    }
+
+    uint64_t size() const
+    {
+        return _size;
+    }
+
+    /*
+    Gives up ownership of the mapping, it should be released with munmap(ptr, size())
+    */
+    void* release()
+    {
+        void* ptr = _ptr;
+        _ptr = nullptr;
+        return ptr;
+    }
+
+    ~mapped_file()
+    {
+        if (_ptr != nullptr)
+        {
+            munmap(_ptr, _size);
+        }
+    }
+private:
+    void*    _ptr;
+    uint64_t _size;
+};
+
+/*
+Replaces the contents of the file with the concatenation of the parts, the copy is done in parallel.
+The data is written with pwrite into a temporary file in the same directory, which is then renamed over the file,
+so a file can be written from its own mapping (the mapping keeps the old contents), and a full disk
+or another write error throws instead of leaving a truncated file.
+*/
+
+struct file_part
+{
+    void const* data;
+    uint64_t    bytes_count;
+};
+
+inline bool write_at(int fd, char const* data, uint64_t bytes_count, uint64_t offset)
+{
+    while (bytes_count > 0)
+    {
+        ssize_t written = pwrite(fd, data, bytes_count, static_cast<off_t>(offset));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        bytes_count -= static_cast<uint64_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+inline void write_file(std::string const& path, std::vector<file_part> const& parts)
+{
+    uint64_t bytes_count = 0;
+    for (file_part const& part : parts)
+    {
+        bytes_count += part.bytes_count;
+    }
+
+    std::string temp_path = path + ".XXXXXX";
+    int fd = mkstemp(&temp_path[0]);
+    if (fd < 0)
+    {
+        throw_file_error("create a temporary file for", path);
+    }
+    auto fail = [fd, &temp_path](std::string const& action, int error)
+    {
+        close(fd);
+        unlink(temp_path.c_str());
+        errno = error;
+        throw_file_error(action, temp_path);
+    };
+    if (fchmod(fd, 0644) != 0)
+    {
+        fail("chmod", errno);
+    }
+    if (bytes_count > 0)
+    {
+        // posix_fallocate returns the error instead of setting errno
+        int error = posix_fallocate(fd, 0, static_cast<off_t>(bytes_count));
+        if (error != 0)
+        {
+            fail("allocate", error);
+        }
+    }
+
+    int error = 0;
+    uint64_t part_offset = 0;
+    for (file_part const& part : parts)
+    {
+        uint64_t blocks_count = (part.bytes_count + FILE_COPY_BLOCK_SIZE - 1) / FILE_COPY_BLOCK_SIZE;
+        #pragma grainsize 1
+        cilk_for (uint64_t i = 0; i < blocks_count; ++i)
+        {
+            uint64_t left = i * FILE_COPY_BLOCK_SIZE;
+            uint64_t right = std::min(left + FILE_COPY_BLOCK_SIZE, part.bytes_count);
+            if (!write_at(fd, static_cast<char const*>(part.data) + left, right - left, part_offset + left))
+            {
+                __atomic_store_n(&error, errno, __ATOMIC_RELAXED);
+            }
+        }
+        part_offset += part.bytes_count;
+    }
+    if (error != 0)
+    {
+        fail("write", error);
+    }
+    if (close(fd) != 0)
+    {
+        error = errno;
+        unlink(temp_path.c_str());
+        errno = error;
+        throw_file_error("close", temp_path);
+    }
+    if (rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        error = errno;
+        unlink(temp_path.c_str());
+        errno = error;
+        throw_file_error("rename", temp_path);
+    }
+}
+
+inline void write_file(std::string const& path, void const* data, uint64_t bytes_count)
+{
+    write_file(path, std::vector<file_part>({{data, bytes_count}}));
+}
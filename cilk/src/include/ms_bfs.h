@@ -0,0 +1,189 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+/*
+Multi-source BFS (MS-BFS, Then et al.): a batch of up to 64 * WORDS traversals runs at once.
+Every node has bitmasks of the sources, which have seen it, have it in the frontier and reach it next,
+so every edge is processed once per level for all sources of the batch together.
+Masks of a node are WORDS consecutive words, fixed-size loops over them are unrolled and vectorized by the compiler.
+*/
+
+const uint64_t MS_BFS_MAX_WORDS = 8;
+const uint64_t MS_BFS_MAX_BATCH_SIZE = 64 * MS_BFS_MAX_WORDS;
+
+/*
+Distances from every source to every node, -1 for unreachable nodes.
+Distances of one node to all sources are stored together, since they are written by the thread of the node.
+*/
+struct distance_matrix
+{
+public:
+    distance_matrix(uint64_t sources_count, uint64_t nodes_count) :
+        _sources_count(sources_count),
+        _nodes_count(nodes_count),
+        _dists(static_cast<long>(sources_count * nodes_count), static_cast<int32_t>(-1))
+    {
+    }
+
+    uint64_t sources_count() const
+    {
+        return _sources_count;
+    }
+
+    uint64_t nodes_count() const
+    {
+        return _nodes_count;
+    }
+
+    int32_t get(uint64_t source_idx, uint64_t node) const
+    {
+        assert(source_idx < _sources_count && node < _nodes_count);
+        return _dists[node * _sources_count + source_idx];
+    }
+
+    void set(uint64_t source_idx, uint64_t node, int32_t dist)
+    {
+        assert(source_idx < _sources_count && node < _nodes_count);
+        _dists[node * _sources_count + source_idx] = dist;
+    }
+private:
+    uint64_t                    _sources_count;
+    uint64_t                    _nodes_count;
+    pasl::pctl::parray<int32_t> _dists;
+};
+
+/*
+Sources first_source, ..., first_source + 64 * WORDS - 1 (or up to the end of sources) as one batch
+*/
+template <uint64_t WORDS, typename Graph>
+void ms_bfs_batch(
+    Graph const& edges, std::vector<uint64_t> const& sources, uint64_t first_source, distance_matrix& result)
+{
+    long nodes_count = static_cast<long>(result.nodes_count());
+    uint64_t batch_size = std::min(64 * WORDS, sources.size() - first_source);
+    assert(batch_size > 0);
+    pasl::pctl::parray<uint64_t> seen(nodes_count * WORDS, static_cast<uint64_t>(0));
+    pasl::pctl::parray<uint64_t> frontier(nodes_count * WORDS, static_cast<uint64_t>(0));
+    pasl::pctl::parray<uint64_t> next(nodes_count * WORDS, static_cast<uint64_t>(0));
+    for (uint64_t source_bit = 0; source_bit < batch_size; ++source_bit)
+    {
+        uint64_t source = sources[first_source + source_bit];
+        assert(source < static_cast<uint64_t>(nodes_count));
+        seen[source * WORDS + source_bit / 64] |= UINT64_C(1) << (source_bit % 64);
+        frontier[source * WORDS + source_bit / 64] |= UINT64_C(1) << (source_bit % 64);
+        result.set(first_source + source_bit, source, 0);
+    }
+
+    int32_t cur_dist = 0;
+    bool frontier_empty = false;
+    while (!frontier_empty)
+    {
+        assert(cur_dist < INT32_MAX);
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), nodes_count,
+            [&edges](long node)
+            {
+                return node_degree(edges, node) + 1;
+            },
+            [&edges, &seen, &frontier, &next](long from_node)
+            {
+                uint64_t const* from_mask = &frontier[from_node * WORDS];
+                uint64_t any_bits = 0;
+                for (uint64_t word_idx = 0; word_idx < WORDS; ++word_idx)
+                {
+                    any_bits |= from_mask[word_idx];
+                }
+                if (any_bits == 0)
+                {
+                    return;
+                }
+                for_each_neighbor(
+                    edges, static_cast<uint64_t>(from_node),
+                    [&seen, &next, from_mask](uint64_t to_node)
+                    {
+                        for (uint64_t word_idx = 0; word_idx < WORDS; ++word_idx)
+                        {
+                            uint64_t bits = from_mask[word_idx] & ~seen[to_node * WORDS + word_idx];
+                            uint64_t* next_word = &next[to_node * WORDS + word_idx];
+                            if ((bits & ~__atomic_load_n(next_word, __ATOMIC_RELAXED)) != 0)
+                            {
+                                __atomic_fetch_or(next_word, bits, __ATOMIC_RELAXED);
+                            }
+                        }
+                    }
+                );
+            }
+        );
+
+        frontier_empty = true;
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), nodes_count,
+            [&seen, &frontier, &next, &result, &frontier_empty, first_source, cur_dist](long node)
+            {
+                uint64_t any_bits = 0;
+                for (uint64_t word_idx = 0; word_idx < WORDS; ++word_idx)
+                {
+                    uint64_t idx = node * WORDS + word_idx;
+                    uint64_t new_bits = next[idx] & ~seen[idx];
+                    seen[idx] |= new_bits;
+                    frontier[idx] = new_bits;
+                    next[idx] = 0;
+                    any_bits |= new_bits;
+                }
+                if (any_bits == 0)
+                {
+                    return;
+                }
+                __atomic_store_n(&frontier_empty, false, __ATOMIC_RELAXED);
+                for (uint64_t word_idx = 0; word_idx < WORDS; ++word_idx)
+                {
+                    uint64_t word = frontier[node * WORDS + word_idx];
+                    while (word != 0)
+                    {
+                        result.set(first_source + word_idx * 64 + __builtin_ctzll(word), node, cur_dist + 1);
+                        word &= word - 1;
+                    }
+                }
+            }
+        );
+        ++cur_dist;
+    }
+}
+
+/*
+Distances from all sources, which are split into batches of at most MS_BFS_MAX_BATCH_SIZE.
+The width of masks is chosen by the size of the batch. Sources may repeat.
+*/
+template <typename Graph>
+distance_matrix multi_source_bfs(uint64_t nodes_count, std::vector<uint64_t> const& sources, Graph const& edges)
+{
+    distance_matrix result(sources.size(), nodes_count);
+    for (uint64_t first_source = 0; first_source < sources.size(); first_source += MS_BFS_MAX_BATCH_SIZE)
+    {
+        uint64_t batch_size = std::min(MS_BFS_MAX_BATCH_SIZE, sources.size() - first_source);
+        if (batch_size <= 64)
+        {
+            ms_bfs_batch<1>(edges, sources, first_source, result);
+        }
+        else if (batch_size <= 128)
+        {
+            ms_bfs_batch<2>(edges, sources, first_source, result);
+        }
+        else if (batch_size <= 256)
+        {
+            ms_bfs_batch<4>(edges, sources, first_source, result);
+        }
+        else
+        {
+            ms_bfs_batch<MS_BFS_MAX_WORDS>(edges, sources, first_source, result);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include "bfs.h"
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <utility>
+
+/*
+PageRank: rank(v) = (1 - damping) / n + damping * sum of rank(u) / degree(u) over edges u -> v.
+Like in the GAP benchmark, ranks of nodes without outgoing edges are not redistributed.
+*/
+
+struct pagerank_options
+{
+    double   damping        = 0.85;
+    // full iterations stop, when the sum of absolute changes of ranks is below epsilon,
+    // delta updates propagate the residual of a node, while it is above epsilon / n
+    double   epsilon        = 1e-7;
+    uint32_t max_iterations = 100;
+    bool     delta_updates  = false;
+};
+
+struct pagerank_result
+{
+    pasl::pctl::parray<double> ranks;
+    uint32_t                   iterations;
+};
+
+/*
+Sequential baseline, push iterations from uniform ranks
+*/
+template <typename V>
+pagerank_result pagerank_sequential(csr_graph<V> const& graph, pagerank_options const& options)
+{
+    uint64_t nodes_count = graph.nodes_count();
+    double base_rank = (1 - options.damping) / nodes_count;
+    std::vector<double> ranks(nodes_count, 1.0 / nodes_count);
+    std::vector<double> new_ranks(nodes_count);
+    uint32_t iteration = 0;
+    while (iteration < options.max_iterations)
+    {
+        ++iteration;
+        std::fill(new_ranks.begin(), new_ranks.end(), base_rank);
+        for (uint64_t from_node = 0; from_node < nodes_count; ++from_node)
+        {
+            uint64_t degree = graph.degree(from_node);
+            for (uint64_t edge_idx = 0; edge_idx < degree; ++edge_idx)
+            {
+                new_ranks[graph.neighbor(from_node, edge_idx)] += options.damping * ranks[from_node] / degree;
+            }
+        }
+        double error = 0;
+        for (uint64_t node = 0; node < nodes_count; ++node)
+        {
+            error += std::abs(new_ranks[node] - ranks[node]);
+        }
+        std::swap(ranks, new_ranks);
+        if (error < options.epsilon)
+        {
+            break;
+        }
+    }
+    return {
+        pasl::pctl::parray<double>(
+            static_cast<long>(nodes_count),
+            [&ranks](long node)
+            {
+                return ranks[node];
+            }
+        ),
+        iteration
+    };
+}
+
+inline double sum_doubles(pasl::pctl::parray<double> const& values)
+{
+    return pasl::pctl::reduce(
+        values.begin(), values.end(), 0.0,
+        [](double x, double y)
+        {
+            return x + y;
+        }
+    );
+}
+
+/*
+Every node reads contributions rank(u) / degree(u) of its in-neighbors, which are written to a separate array
+before the iteration, so there are no write conflicts and the in-neighbors are read in increasing order.
+*/
+template <typename V>
+pagerank_result pagerank_pull_full(
+    csr_graph<V> const& graph, csr_graph<V> const& in_graph, pagerank_options const& options)
+{
+    long nodes_count = static_cast<long>(graph.nodes_count());
+    double base_rank = (1 - options.damping) / nodes_count;
+    double damping = options.damping;
+    pasl::pctl::parray<double> ranks(nodes_count, 1.0 / nodes_count);
+    pasl::pctl::parray<double> new_ranks(nodes_count);
+    pasl::pctl::parray<double> contributions(nodes_count);
+    pasl::pctl::parray<double> changes(nodes_count);
+    uint32_t iteration = 0;
+    while (iteration < options.max_iterations)
+    {
+        ++iteration;
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), nodes_count,
+            [&graph, &ranks, &contributions, damping](long node)
+            {
+                uint64_t degree = graph.degree(node);
+                contributions[node] = degree == 0 ? 0.0 : damping * ranks[node] / degree;
+            }
+        );
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), nodes_count,
+            [&in_graph](long node)
+            {
+                return in_graph.degree(node) + 1;
+            },
+            [&in_graph, &ranks, &new_ranks, &contributions, &changes, base_rank](long to_node)
+            {
+                double rank = base_rank;
+                for_each_neighbor(
+                    in_graph, static_cast<uint64_t>(to_node),
+                    [&contributions, &rank](uint64_t from_node)
+                    {
+                        rank += contributions[from_node];
+                    }
+                );
+                new_ranks[to_node] = rank;
+                changes[to_node] = std::abs(rank - ranks[to_node]);
+            }
+        );
+        std::swap(ranks, new_ranks);
+        if (sum_doubles(changes) < options.epsilon)
+        {
+            break;
+        }
+    }
+    return {std::move(ranks), iteration};
+}
+
+/*
+Delta updates: ranks start from zero and every node has a residual, which is the rank it has not propagated yet.
+An iteration adds residuals of the active nodes (the ones with residual above the threshold) to their ranks
+and pulls them into the residuals of their out-neighbors. Only out-neighbors of the active nodes are pulled,
+they are found by a top-down step over the active nodes, so late iterations touch a small part of the graph.
+Residuals, which are left below the threshold, are added to ranks in the end.
+*/
+template <typename V>
+pagerank_result pagerank_pull_delta(
+    csr_graph<V> const& graph, csr_graph<V> const& in_graph, pagerank_options const& options)
+{
+    long nodes_count = static_cast<long>(graph.nodes_count());
+    double threshold = options.epsilon / nodes_count;
+    double damping = options.damping;
+    pasl::pctl::parray<double> ranks(nodes_count, 0.0);
+    pasl::pctl::parray<double> residuals(nodes_count, (1 - options.damping) / nodes_count);
+    pasl::pctl::parray<double> contributions(nodes_count, 0.0);
+    pasl::pctl::parray<uint64_t> stamps(nodes_count, static_cast<uint64_t>(0));
+    pasl::pctl::parray<int64_t> all_nodes(
+        nodes_count,
+        [](long node)
+        {
+            return static_cast<int64_t>(node);
+        }
+    );
+    auto is_active = [&residuals, threshold](int64_t node)
+    {
+        return residuals[node] > threshold;
+    };
+    pasl::pctl::parray<int64_t> active = pasl::pctl::filter(all_nodes.begin(), all_nodes.end(), is_active);
+    uint32_t iteration = 0;
+    while (active.size() > 0 && iteration < options.max_iterations)
+    {
+        ++iteration;
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), active.size(),
+            [&graph, &active, &ranks, &residuals, &contributions, damping](long node_idx)
+            {
+                int64_t node = active[node_idx];
+                uint64_t degree = graph.degree(node);
+                ranks[node] += residuals[node];
+                contributions[node] = degree == 0 ? 0.0 : damping * residuals[node] / degree;
+                residuals[node] = 0;
+            }
+        );
+        pasl::pctl::parray<int64_t> touched = expand_frontier(
+            graph, active,
+            [&stamps, iteration](uint64_t, uint64_t to_node, uint64_t)
+            {
+                return claim_node(stamps, to_node, iteration);
+            }
+        );
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), touched.size(),
+            [&in_graph, &touched](long node_idx)
+            {
+                return in_graph.degree(touched[node_idx]) + 1;
+            },
+            [&in_graph, &touched, &residuals, &contributions](long node_idx)
+            {
+                uint64_t to_node = static_cast<uint64_t>(touched[node_idx]);
+                double residual = 0;
+                for_each_neighbor(
+                    in_graph, to_node,
+                    [&contributions, &residual](uint64_t from_node)
+                    {
+                        residual += contributions[from_node];
+                    }
+                );
+                residuals[to_node] += residual;
+            }
+        );
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), active.size(),
+            [&active, &contributions](long node_idx)
+            {
+                contributions[active[node_idx]] = 0;
+            }
+        );
+        active = pasl::pctl::filter(touched.begin(), touched.end(), is_active);
+    }
+
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes_count,
+        [&ranks, &residuals](long node)
+        {
+            ranks[node] += residuals[node];
+        }
+    );
+    return {std::move(ranks), iteration};
+}
+
+/*
+Parallel pull PageRank, in_graph must be the transpose of graph (see transpose_graph)
+*/
+template <typename V>
+pagerank_result pagerank_pull(csr_graph<V> const& graph, csr_graph<V> const& in_graph, pagerank_options const& options)
+{
+    assert(graph.nodes_count() == in_graph.nodes_count());
+    assert(graph.edges_count() == in_graph.edges_count());
+    if (options.delta_updates)
+    {
+        return pagerank_pull_delta(graph, in_graph, options);
+    }
+    return pagerank_pull_full(graph, in_graph, options);
+}
@@ -1,42 +1,184 @@
 #pragma once
 
+#include "mapped_file.h"
+#include <cilk/cilk.h>
 #include <cstdint>
 #include <new>
 #include <type_traits>
+#include <utility>
+#include <string>
+#include <stdexcept>
+#include <sys/mman.h>
 
 template <typename T>
 struct raw_array
 {
 public:
-    raw_array(uint32_t array_size) : _size(array_size),
-                                     _ptr(nullptr) 
+    /*
+    Elements of trivially default constructible types are left uninitialized,
+    elements of other types are default constructed in parallel
+    */
+    raw_array(uint32_t array_size) : raw_array(array_size, uninitialized_tag())
     {
-        static_assert(std::is_trivially_destructible<T>::value, "Type parameter should be trivially destructible");
-        if (_size > 0)
+        if constexpr (!std::is_trivially_default_constructible<T>::value)
         {
-            _ptr = static_cast<T*>(::operator new(sizeof(T) * _size));
+            cilk_for (uint32_t i = 0; i < _size; ++i)
+            {
+                new (_ptr + i) T();
+            }
         }
     }
 
-    raw_array(raw_array<T> const& other) : _size(other._size),
-                                           _ptr(nullptr) 
+    raw_array(uint32_t array_size, T const& value) : raw_array(array_size, uninitialized_tag())
     {
-        if (_size > 0)
+        cilk_for (uint32_t i = 0; i < _size; ++i)
         {
-            _ptr = static_cast<T*>(::operator new(sizeof(T) * other._size));
-            for (uint32_t i = 0; i < other._size; ++i)
-            {
-                *(_ptr + i) = other[i];
-            }
+            new (_ptr + i) T(value);
+        }
+    }
+
+    /*
+    Element i is initialized with generator(i), elements are generated in parallel
+    */
+    template <
+        typename Generator,
+        typename = std::enable_if_t<std::is_invocable_r<T, Generator const&, uint32_t>::value>
+    >
+    raw_array(uint32_t array_size, Generator const& generator) : raw_array(array_size, uninitialized_tag())
+    {
+        cilk_for (uint32_t i = 0; i < _size; ++i)
+        {
+            new (_ptr + i) T(generator(i));
         }
     }
 
-    raw_array(raw_array<T>&& other) noexcept : 
+    raw_array(raw_array<T> const& other) : raw_array(other._size, uninitialized_tag())
+    {
+        cilk_for (uint32_t i = 0; i < _size; ++i)
+        {
+            new (_ptr + i) T(other[i]);
+        }
+    }
+
+    /*
+    Copy of an array of const elements, for example of a ReadOnly mapping, elements are copied in parallel
+    */
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_same<U, T const>::value && !std::is_same<U, T>::value>
+    >
+    raw_array(raw_array<U> const& other) : raw_array(other.size(), uninitialized_tag())
+    {
+        cilk_for (uint32_t i = 0; i < _size; ++i)
+        {
+            new (_ptr + i) T(other[i]);
+        }
+    }
+
+    raw_array(raw_array<T>&& other) noexcept :
         _size(other._size),
-        _ptr(other._ptr) 
+        _ptr(other._ptr),
+        _mapped(other._mapped)
     {
         other._ptr = nullptr;
         other._size = 0;
+        other._mapped = false;
+    }
+
+    /*
+    Allocates memory without constructing elements. Every element must be constructed
+    with placement new before the array is read or destroyed.
+    */
+    static raw_array<T> uninitialized(uint32_t array_size)
+    {
+        return raw_array<T>(array_size, uninitialized_tag());
+    }
+
+    static raw_array<T> iota(uint32_t array_size, T const& first)
+    {
+        return raw_array<T>(
+            array_size,
+            [&first](uint32_t idx)
+            {
+                return static_cast<T>(first + idx);
+            }
+        );
+    }
+
+    /*
+    Creates an array backed by a mapping of the whole file, no data is copied.
+    A ReadOnly mapping is an array of const elements, since its pages are not writable.
+    Elements of a CopyOnWrite array can be modified without changing the file.
+    */
+    template <MapMode Mode>
+    static raw_array<std::conditional_t<Mode == MapMode::ReadOnly, T const, T>> map_file(
+        std::string const& path, bool populate = true, int advice = MADV_SEQUENTIAL)
+    {
+        using mapped_type = std::conditional_t<Mode == MapMode::ReadOnly, T const, T>;
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be mapped");
+        mapped_file file(path, Mode, populate, advice);
+        if (file.size() % sizeof(T) != 0 || file.size() / sizeof(T) > UINT32_MAX)
+        {
+            throw std::runtime_error("size of " + path + " does not match the element type");
+        }
+        raw_array<mapped_type> result(0, typename raw_array<mapped_type>::uninitialized_tag());
+        result._size = static_cast<uint32_t>(file.size() / sizeof(T));
+        result._ptr = static_cast<mapped_type*>(file.release());
+        result._mapped = (result._ptr != nullptr);
+        return result;
+    }
+
+    void write_to_file(std::string const& path) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written");
+        write_file(path, _ptr, static_cast<uint64_t>(_size) * sizeof(T));
+    }
+
+    raw_array<T>& operator=(raw_array<T> const& other)
+    {
+        if (this != &other)
+        {
+            if (_size != other._size || _mapped)
+            {
+                raw_array<T> tmp(other);
+                swap(tmp);
+            }
+            else
+            {
+                cilk_for (uint32_t i = 0; i < _size; ++i)
+                {
+                    _ptr[i] = other[i];
+                }
+            }
+        }
+        return *this;
+    }
+
+    raw_array<T>& operator=(raw_array<T>&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    void assign(uint32_t new_size, T const& value)
+    {
+        if (_size != new_size || _mapped)
+        {
+            raw_array<T> tmp(new_size, value);
+            swap(tmp);
+        }
+        else
+        {
+            fill(value);
+        }
+    }
+
+    void fill(T const& value)
+    {
+        cilk_for (uint32_t i = 0; i < _size; ++i)
+        {
+            _ptr[i] = value;
+        }
     }
 
     T* get_raw_ptr()
@@ -49,12 +191,32 @@ public:
         return _ptr;
     }
 
-    T const& operator[](uint32_t idx) const 
+    T* begin()
+    {
+        return _ptr;
+    }
+
+    T const* begin() const
+    {
+        return _ptr;
+    }
+
+    T* end()
+    {
+        return _ptr + _size;
+    }
+
+    T const* end() const
+    {
+        return _ptr + _size;
+    }
+
+    T const& operator[](uint32_t idx) const
     {
         return *(_ptr + idx);
     }
 
-    T& operator[](uint32_t idx) 
+    T& operator[](uint32_t idx)
     {
         return *(_ptr + idx);
     }
@@ -64,14 +226,58 @@ public:
         return _size;
     }
 
+    bool is_mapped() const
+    {
+        return _mapped;
+    }
+
+    void swap(raw_array<T>& other) noexcept
+    {
+        std::swap(_size, other._size);
+        std::swap(_ptr, other._ptr);
+        std::swap(_mapped, other._mapped);
+    }
+
     ~raw_array()
     {
         if (_ptr != nullptr)
         {
-            ::operator delete(_ptr);
+            if (_mapped)
+            {
+                munmap(const_cast<std::remove_const_t<T>*>(_ptr), static_cast<uint64_t>(_size) * sizeof(T));
+            }
+            else
+            {
+                if constexpr (!std::is_trivially_destructible<T>::value)
+                {
+                    cilk_for (uint32_t i = 0; i < _size; ++i)
+                    {
+                        _ptr[i].~T();
+                    }
+                }
+                ::operator delete(const_cast<std::remove_const_t<T>*>(_ptr));
+            }
         }
     }
 private:
+    template <typename U>
+    friend struct raw_array;
+
+    struct uninitialized_tag
+    {
+    };
+
+    raw_array(uint32_t array_size, uninitialized_tag) : _size(array_size),
+                                                        _ptr(nullptr),
+                                                        _mapped(false)
+    {
+        if (_size > 0)
+        {
+            _ptr = static_cast<T*>(::operator new(sizeof(T) * _size));
+        }
+    }
+
     uint32_t _size;
     T*       _ptr;
+    bool     _mapped;
 };
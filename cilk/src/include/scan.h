@@ -2,8 +2,9 @@
 
 #include <cstdint>
 #include "raw_array.h"
+#include "array_view.h"
 #include <utility>
 
-std::pair<raw_array<int32_t>, int32_t> scan_exclusive_blocked(raw_array<int32_t> const& x, uint32_t blocks_count);
+std::pair<raw_array<int32_t>, int32_t> scan_exclusive_blocked(array_view<int32_t const> x, uint32_t blocks_count);
 
-std::pair<raw_array<int32_t>, int32_t> scan_exclusive_sequential(raw_array<int32_t> const& x);
+std::pair<raw_array<int32_t>, int32_t> scan_exclusive_sequential(array_view<int32_t const> x);
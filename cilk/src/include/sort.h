@@ -1,6 +1,7 @@
 #pragma once
 
 #include "raw_array.h"
+#include "array_view.h"
 #include "map_parallel.h"
 #include "filter_parallel.h"
 #include "scan.h"
@@ -15,11 +16,17 @@
 #include <string>
 #include <vector>
 #include <random>
+#include <utility>
 
 /*
 Sequential sort
 */
 
+/*
+Moves the partitioner to its final position and returns it: elements to the left of it
+are not greater and elements to the right of it are not less than the partitioner.
+The partitioner is never copied, so move-only types can be sorted.
+*/
 template <typename T, template <typename, typename ...> typename C>
 uint32_t partition(C<T>& arr, uint32_t left, uint32_t right, std::default_random_engine& generator)
 {
@@ -27,17 +34,20 @@ uint32_t partition(C<T>& arr, uint32_t left, uint32_t right, std::default_random
     std::uniform_int_distribution<uint32_t> p_idx_distribution(left, right);
     uint32_t partitioner_idx = p_idx_distribution(generator);
     assert(left <= partitioner_idx && partitioner_idx <= right);
-    T partitioner = arr[partitioner_idx];
+    std::swap(arr[left], arr[partitioner_idx]);
+    T const& partitioner = arr[left];
 
     uint32_t i = left;
-    uint32_t j = right;
-    while (i <= j)
+    uint32_t j = right + 1;
+    while (true)
     {
-        while(arr[i] < partitioner)
+        ++i;
+        while (i < right && arr[i] < partitioner)
         {
             ++i;
         }
-        while(arr[j] > partitioner)
+        --j;
+        while (j > left && arr[j] > partitioner)
         {
             --j;
         }
@@ -46,9 +56,8 @@ uint32_t partition(C<T>& arr, uint32_t left, uint32_t right, std::default_random
             break;
         }
         std::swap(arr[i], arr[j]);
-        ++i;
-        --j;
     }
+    std::swap(arr[left], arr[j]);
     return j;
 }
 
@@ -61,7 +70,10 @@ void do_sort_sequential(C<T>& arr, uint32_t left, uint32_t right, std::default_r
     }
     assert(0 <= left && left < right && right < arr.size());
     uint32_t p_idx = partition(arr, left, right, generator);
-    do_sort_sequential(arr, left,      p_idx, generator);
+    if (p_idx > left)
+    {
+        do_sort_sequential(arr, left, p_idx - 1, generator);
+    }
     do_sort_sequential(arr, p_idx + 1, right, generator);
 }
 
@@ -92,15 +104,19 @@ void sort_parallel_no_filters(
     assert(0 <= left && left < right && right < arr.size());
     uint32_t p_idx = partition(arr, left, right, generator);
 
-    if (right - left + 1 <= seq_block_size)
+    if (p_idx == left)
     {
-        sort_parallel_no_filters(arr, left,      p_idx, seq_block_size, generator);
         sort_parallel_no_filters(arr, p_idx + 1, right, seq_block_size, generator);
     }
+    else if (right - left + 1 <= seq_block_size)
+    {
+        sort_parallel_no_filters(arr, left,      p_idx - 1, seq_block_size, generator);
+        sort_parallel_no_filters(arr, p_idx + 1, right,     seq_block_size, generator);
+    }
     else
     {
-        cilk_spawn sort_parallel_no_filters(arr, left,      p_idx, seq_block_size, generator);
-                   sort_parallel_no_filters(arr, p_idx + 1, right, seq_block_size, generator);
+        cilk_spawn sort_parallel_no_filters(arr, left,      p_idx - 1, seq_block_size, generator);
+                   sort_parallel_no_filters(arr, p_idx + 1, right,     seq_block_size, generator);
         cilk_sync;
     }
 }
@@ -120,10 +136,10 @@ void sort_parallel_no_filters(C<T>& arr, uint32_t seq_block_size)
 Parallel sort with parallel filters
 */
 
-template <typename T, template <typename, typename ...> typename C>
-void copy_parallel(C<T> const& src, C<T>& dst, uint32_t start_idx, uint32_t seq_block_size)
+template <typename T>
+void copy_parallel(array_view<T const> src, array_view<T> dst, uint32_t seq_block_size)
 {
-    assert(src.size() + start_idx <= dst.size());
+    assert(src.size() == dst.size());
     if (src.size() == 0)
     {
         return;
@@ -146,13 +162,112 @@ void copy_parallel(C<T> const& src, C<T>& dst, uint32_t start_idx, uint32_t seq_
         }
         for (uint32_t j = left; j < right; ++j)
         {
-            dst[start_idx + j] = src[j];
+            dst[j] = src[j];
+        }
+    }
+}
+
+template <typename T>
+void move_parallel(array_view<T> src, array_view<T> dst, uint32_t seq_block_size)
+{
+    assert(src.size() == dst.size());
+    if (src.size() == 0)
+    {
+        return;
+    }
+
+    uint32_t blocks_count = src.size() / seq_block_size;
+    if (src.size() % seq_block_size != 0)
+    {
+        ++blocks_count;
+    }
+    
+    #pragma grainsize 1
+    cilk_for (uint32_t i = 0; i < blocks_count; ++i)
+    {
+        uint32_t left = i * seq_block_size;
+        uint32_t right = left + seq_block_size;
+        if (right > src.size())
+        {
+            right = src.size();
+        }
+        for (uint32_t j = left; j < right; ++j)
+        {
+            dst[j] = std::move(src[j]);
+        }
+    }
+}
+
+/*
+Rearranges arr into [< partitioner, == partitioner, > partitioner],
+returns the bounds of the middle part.
+The three filters share the flags and are fused into a single scatter, which moves
+every element exactly twice: into a temporary array and back into arr.
+*/
+template <typename T>
+std::pair<uint32_t, uint32_t> partition_parallel(
+    array_view<T> arr, T const& partitioner, uint32_t seq_block_size)
+{
+    uint32_t blocks_count = arr.size() / seq_block_size;
+    uint32_t elements_per_block = arr.size() / blocks_count;
+    if (arr.size() % blocks_count != 0)
+    {
+        ++elements_per_block;
+    }
+
+    raw_array<int32_t> le_flags = cilk_spawn map_parallel<T, int32_t>(
+        arr, [&partitioner](T const& x) { return x <  partitioner ? 1 : 0; }, blocks_count
+    );
+    raw_array<int32_t> eq_flags =            map_parallel<T, int32_t>(
+        arr, [&partitioner](T const& x) { return x == partitioner ? 1 : 0; }, blocks_count
+    );
+    cilk_sync;
+
+    std::pair<raw_array<int32_t>, int32_t> le_scan = cilk_spawn scan_exclusive_blocked(le_flags, blocks_count);
+    std::pair<raw_array<int32_t>, int32_t> eq_scan =            scan_exclusive_blocked(eq_flags, blocks_count);
+    cilk_sync;
+
+    raw_array<int32_t> const& le_idxs = le_scan.first;
+    raw_array<int32_t> const& eq_idxs = eq_scan.first;
+    uint32_t eq_start = le_scan.second;
+    uint32_t gt_start = le_scan.second + eq_scan.second;
+
+    raw_array<T> tmp = raw_array<T>::uninitialized(arr.size());
+
+    #pragma grainsize 1
+    cilk_for (uint32_t i = 0; i < blocks_count; ++i)
+    {
+        uint32_t left = i * elements_per_block;
+        uint32_t right = left + elements_per_block;
+        if (right > arr.size())
+        {
+            right = arr.size();
+        }
+        for (uint32_t j = left; j < right; ++j)
+        {
+            uint32_t dst_idx = 0;
+            if (le_flags[j] == 1)
+            {
+                dst_idx = le_idxs[j];
+            }
+            else if (eq_flags[j] == 1)
+            {
+                dst_idx = eq_start + eq_idxs[j];
+            }
+            else
+            {
+                dst_idx = gt_start + (j - le_idxs[j] - eq_idxs[j]);
+            }
+            new (tmp.get_raw_ptr() + dst_idx) T(std::move(arr[j]));
         }
     }
+
+    move_parallel<T>(tmp, arr, seq_block_size);
+    return {eq_start, gt_start};
 }
 
 template <typename T>
-void do_sort_parallel(raw_array<T>& arr, uint32_t seq_block_size, std::default_random_engine& generator)
+void do_sort_parallel(array_view<T> arr, uint32_t seq_block_size, std::default_random_engine& generator)
 {
     if (arr.size() <= 1)
     {
@@ -169,57 +284,95 @@ void do_sort_parallel(raw_array<T>& arr, uint32_t seq_block_size, std::default_r
     assert(0 <= partitioner_idx && partitioner_idx < arr.size());
     T const& partitioner = arr[partitioner_idx];
 
-    uint32_t blocks_count = arr.size() / seq_block_size;
-
-    raw_array<T> le = cilk_spawn filter_parallel<T>(
-        arr, [&partitioner](T const& x) { return x <  partitioner; }, blocks_count
-    );
-    raw_array<T> eq = cilk_spawn filter_parallel<T>(
-        arr, [&partitioner](T const& x) { return x == partitioner; }, blocks_count
-    );
-    raw_array<T> gt =            filter_parallel<T>(
-        arr, [&partitioner](T const& x) { return x >  partitioner; }, blocks_count
-    );
-    cilk_sync;
-
-    cilk_spawn do_sort_parallel(le, seq_block_size, generator);
-               do_sort_parallel(gt, seq_block_size, generator);
-    cilk_sync;
+    auto [eq_start, gt_start] = partition_parallel(arr, partitioner, seq_block_size);
 
-    cilk_spawn copy_parallel(le, arr, 0,                     seq_block_size);
-    cilk_spawn copy_parallel(eq, arr, le.size(),             seq_block_size);
-               copy_parallel(gt, arr, le.size() + eq.size(), seq_block_size);
+    cilk_spawn do_sort_parallel(arr.slice(0,        eq_start),   seq_block_size, generator);
+               do_sort_parallel(arr.slice(gt_start, arr.size()), seq_block_size, generator);
     cilk_sync;
 }
 
-
 template <typename T>
-void sort_parallel(raw_array<T>& arr, uint32_t seq_block_size)
+void sort_parallel(array_view<T> arr, uint32_t seq_block_size)
 {
     std::default_random_engine generator(time(nullptr));
     do_sort_parallel(arr, seq_block_size, generator);
 }
 
+template <typename T>
+void sort_parallel(raw_array<T>& arr, uint32_t seq_block_size)
+{
+    sort_parallel(array_view<T>(arr), seq_block_size);
+}
+
 /*
 Parallel sort with sequential filters
 */
 
 template <typename T>
-std::vector<T> filter_sequential(std::vector<T> const& vals, std::function<bool(T const&)> pred)
+std::vector<uint32_t> filter_indexes_sequential(array_view<T const> vals, std::function<bool(T const&)> pred)
 {
-    std::vector<T> res;
+    std::vector<uint32_t> res;
     for (uint32_t i = 0; i < vals.size(); ++i)
     {
         if (pred(vals[i]))
         {
-            res.push_back(vals[i]);
+            res.push_back(i);
         }
     }
     return res;
 }
 
 template <typename T>
-void do_sort_parallel_filter_seq(std::vector<T>& arr, uint32_t seq_block_size, std::default_random_engine& generator)
+std::vector<T> move_by_indexes(array_view<T> src, std::vector<uint32_t> const& idxs)
+{
+    std::vector<T> res;
+    res.reserve(idxs.size());
+    for (uint32_t idx : idxs)
+    {
+        res.push_back(std::move(src[idx]));
+    }
+    return res;
+}
+
+/*
+The filters only compare (the partitioner is an element of arr, so nothing may be moved out before they finish)
+and return indexes, then the elements are moved out of arr into temporaries and back,
+so they are never copied and may be move-only.
+*/
+template <typename T>
+std::pair<uint32_t, uint32_t> partition_filter_seq(
+    array_view<T> arr, T const& partitioner, uint32_t seq_block_size)
+{
+    std::vector<uint32_t> le_idxs = cilk_spawn filter_indexes_sequential<T>(
+        arr, [&partitioner](T const& x) { return x <  partitioner; }
+    );
+    std::vector<uint32_t> eq_idxs = cilk_spawn filter_indexes_sequential<T>(
+        arr, [&partitioner](T const& x) { return x == partitioner; }
+    );
+    std::vector<uint32_t> gt_idxs =            filter_indexes_sequential<T>(
+        arr, [&partitioner](T const& x) { return x >  partitioner; }
+    );
+    cilk_sync;
+
+    uint32_t eq_start = le_idxs.size();
+    uint32_t gt_start = le_idxs.size() + eq_idxs.size();
+    assert(gt_start + gt_idxs.size() == arr.size());
+
+    std::vector<T> le = cilk_spawn move_by_indexes(arr, le_idxs);
+    std::vector<T> eq = cilk_spawn move_by_indexes(arr, eq_idxs);
+    std::vector<T> gt =            move_by_indexes(arr, gt_idxs);
+    cilk_sync;
+
+    cilk_spawn move_parallel<T>(le, arr.slice(0,        eq_start),   seq_block_size);
+    cilk_spawn move_parallel<T>(eq, arr.slice(eq_start, gt_start),   seq_block_size);
+               move_parallel<T>(gt, arr.slice(gt_start, arr.size()), seq_block_size);
+    cilk_sync;
+
+    return {eq_start, gt_start};
+}
+
+template <typename T>
+void do_sort_parallel_filter_seq(array_view<T> arr, uint32_t seq_block_size, std::default_random_engine& generator)
 {
     if (arr.size() <= 1)
     {
@@ -227,7 +380,7 @@ void do_sort_parallel_filter_seq(std::vector<T>& arr, uint32_t seq_block_size, s
     }
     if (arr.size() <= seq_block_size)
     {
-        do_sort_sequential<T, std::vector>(arr, 0, arr.size() - 1, generator);
+        do_sort_sequential(arr, 0, arr.size() - 1, generator);
         return;
     }
 
@@ -236,24 +389,10 @@ void do_sort_parallel_filter_seq(std::vector<T>& arr, uint32_t seq_block_size, s
     assert(0 <= partitioner_idx && partitioner_idx < arr.size());
     T const& partitioner = arr[partitioner_idx];
 
-    std::vector<T> le = cilk_spawn filter_sequential<T>(
-        arr, [&partitioner](T const& x) { return x <  partitioner; }
-    );
-    std::vector<T> eq = cilk_spawn filter_sequential<T>(
-        arr, [&partitioner](T const& x) { return x == partitioner; }
-    );
-    std::vector<T> gt =            filter_sequential<T>(
-        arr, [&partitioner](T const& x) { return x >  partitioner; }
-    );
-    cilk_sync;
+    auto [eq_start, gt_start] = partition_filter_seq(arr, partitioner, seq_block_size);
 
-    cilk_spawn do_sort_parallel_filter_seq(le, seq_block_size, generator);
-               do_sort_parallel_filter_seq(gt, seq_block_size, generator);
-    cilk_sync;
-
-    cilk_spawn copy_parallel(le, arr, 0,                     seq_block_size);
-    cilk_spawn copy_parallel(eq, arr, le.size(),             seq_block_size);
-               copy_parallel(gt, arr, le.size() + eq.size(), seq_block_size);
+    cilk_spawn do_sort_parallel_filter_seq(arr.slice(0,        eq_start),   seq_block_size, generator);
+               do_sort_parallel_filter_seq(arr.slice(gt_start, arr.size()), seq_block_size, generator);
     cilk_sync;
 }
 
@@ -261,5 +400,12 @@ template <typename T>
 void sort_parallel_filter_seq(std::vector<T>& arr, uint32_t seq_block_size)
 {
     std::default_random_engine generator(time(nullptr));
-    do_sort_parallel_filter_seq(arr, seq_block_size, generator);
+    do_sort_parallel_filter_seq(array_view<T>(arr), seq_block_size, generator);
+}
+
+template <typename T>
+void sort_parallel_filter_seq(raw_array<T>& arr, uint32_t seq_block_size)
+{
+    std::default_random_engine generator(time(nullptr));
+    do_sort_parallel_filter_seq(array_view<T>(arr), seq_block_size, generator);
 }
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include "weighted_graph.h"
+#include "bfs.h"
+#include <cstdint>
+#include <cassert>
+#include <queue>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <cilk/cilk_api.h>
+
+/*
+Single-source shortest paths on graphs with non-negative weights, -1 for unreachable nodes
+*/
+
+template <typename V, typename W>
+std::vector<int64_t> sssp_dijkstra(uint64_t nodes_count, uint64_t start_node, weighted_csr_graph<V, W> const& graph)
+{
+    assert(start_node < nodes_count);
+    std::vector<int64_t> result(nodes_count, -1);
+    std::priority_queue<
+        std::pair<int64_t, uint64_t>, std::vector<std::pair<int64_t, uint64_t>>, std::greater<std::pair<int64_t, uint64_t>>
+    > q;
+    result[start_node] = 0;
+    q.push({0, start_node});
+
+    while (!q.empty())
+    {
+        auto [dist, from_node] = q.top();
+        q.pop();
+        // entries are never updated in place, so stale ones are skipped
+        if (dist != result[from_node])
+        {
+            continue;
+        }
+        for (uint64_t edge_idx = 0; edge_idx < graph.degree(from_node); ++edge_idx)
+        {
+            uint64_t to_node = static_cast<uint64_t>(graph.neighbor(from_node, edge_idx));
+            int64_t new_dist = dist + static_cast<int64_t>(graph.weight(from_node, edge_idx));
+            if (result[to_node] == -1 || new_dist < result[to_node])
+            {
+                result[to_node] = new_dist;
+                q.push({new_dist, to_node});
+            }
+        }
+    }
+    return result;
+}
+
+/*
+Delta-stepping (Meyer, Sanders). Nodes are kept in buckets of width delta by their tentative distances.
+The minimal bucket is settled by relaxing its light edges (weight <= delta) until it stops changing,
+then heavy edges of all its nodes are relaxed once, since they can not lead back into the bucket.
+Relaxations are parallel loops with an atomic min on distances, improved nodes are appended to the buckets
+of their new distances, so a round touches only the current bucket and the edges of its nodes.
+
+Buckets may have duplicates and stale entries (nodes, whose distances have decreased since), which are removed,
+when the bucket is taken: nodes are deduplicated by stamps, a node is kept by the first thread,
+which writes the current round into its stamp.
+*/
+
+inline pasl::pctl::parray<int64_t> unique_nodes(
+    pasl::pctl::parray<int64_t> const& nodes, pasl::pctl::parray<uint64_t>& stamps, uint64_t round)
+{
+    pasl::pctl::parray<int64_t> claimed(
+        nodes.size(),
+        [&nodes, &stamps, round](long node_idx)
+        {
+            return claim_node(stamps, static_cast<uint64_t>(nodes[node_idx]), round) ? nodes[node_idx] : -1;
+        }
+    );
+    return pasl::pctl::filter(
+        claimed.begin(), claimed.end(),
+        [](int64_t node)
+        {
+            return node != -1;
+        }
+    );
+}
+
+/*
+Buckets with per-worker lists (like the local bins of the GAP benchmark): a worker appends a node
+to its own list of the bucket without synchronization, taking a bucket concatenates the lists of all workers.
+Buckets [first, first + ring_size) are stored in a ring, absolute bucket b is in slot b % ring_size,
+and first moves to every bucket, which is found. Entries of farther buckets go to per-worker overflow lists,
+which are moved into the ring, when it becomes empty, so the memory does not depend on the weights.
+A relaxation from bucket b reaches buckets up to b + max_weight / delta + 1, so the overflow is not used,
+when the ring has max_weight / delta + 2 slots.
+*/
+struct delta_stepping_buckets
+{
+public:
+    delta_stepping_buckets(
+        uint64_t ring_size, uint64_t workers_count = static_cast<uint64_t>(__cilkrts_get_nworkers())) :
+        _workers(workers_count, worker_slots(ring_size)),
+        _offsets(workers_count + 1, 0),
+        _ring_size(ring_size),
+        _first(0)
+    {
+        assert(ring_size > 0 && workers_count > 0);
+    }
+
+    uint64_t ring_size() const
+    {
+        return _ring_size;
+    }
+
+    /*
+    Can be called in parallel, bucket must not be less than the last found bucket
+    */
+    void add(uint64_t node, uint64_t bucket)
+    {
+        assert(bucket >= _first);
+        uint64_t worker = static_cast<uint64_t>(__cilkrts_get_worker_number());
+        assert(worker < _workers.size());
+        if (bucket - _first < _ring_size)
+        {
+            _workers[worker].ring[bucket % _ring_size].push_back(static_cast<int64_t>(node));
+        }
+        else
+        {
+            _workers[worker].overflow.push_back({static_cast<int64_t>(node), bucket});
+        }
+    }
+
+    /*
+    Minimal bucket with entries, which is not less than from, UINT64_MAX if there is none.
+    Buckets before from must be empty. The ring is scanned upwards from the last found bucket,
+    so a traversal scans every slot once per pass over the ring.
+    */
+    uint64_t next_bucket(uint64_t from)
+    {
+        assert(from >= _first);
+        while (true)
+        {
+            for (uint64_t bucket = from; bucket < _first + _ring_size; ++bucket)
+            {
+                for (worker_slots const& worker : _workers)
+                {
+                    if (!worker.ring[bucket % _ring_size].empty())
+                    {
+                        _first = bucket;
+                        return bucket;
+                    }
+                }
+            }
+            if (!refill())
+            {
+                return UINT64_MAX;
+            }
+            from = _first;
+        }
+    }
+
+    /*
+    Removes all entries of the bucket and returns them
+    */
+    pasl::pctl::parray<int64_t> take(uint64_t bucket)
+    {
+        assert(bucket >= _first && bucket - _first < _ring_size);
+        uint64_t slot = bucket % _ring_size;
+        for (uint64_t worker = 0; worker < _workers.size(); ++worker)
+        {
+            _offsets[worker + 1] = _offsets[worker] + _workers[worker].ring[slot].size();
+        }
+        pasl::pctl::parray<int64_t> result(static_cast<long>(_offsets.back()));
+        pasl::pctl::parallel_for(
+            static_cast<uint64_t>(0), static_cast<uint64_t>(_workers.size()),
+            [this](uint64_t worker)
+            {
+                return _offsets[worker + 1] - _offsets[worker] + 1;
+            },
+            [this, &result, slot](uint64_t worker)
+            {
+                std::vector<int64_t>& nodes = _workers[worker].ring[slot];
+                std::copy(nodes.begin(), nodes.end(), result.begin() + _offsets[worker]);
+                nodes.clear();
+            }
+        );
+        return result;
+    }
+private:
+    /*
+    The ring must be empty: it is moved to the minimal overflow bucket and receives the overflow entries,
+    which fit into it. Returns false, if there are no overflow entries.
+    */
+    bool refill()
+    {
+        uint64_t workers_count = static_cast<uint64_t>(_workers.size());
+        std::vector<uint64_t> min_buckets(workers_count, UINT64_MAX);
+        pasl::pctl::parallel_for(
+            static_cast<uint64_t>(0), workers_count,
+            [this](uint64_t worker)
+            {
+                return static_cast<uint64_t>(_workers[worker].overflow.size()) + 1;
+            },
+            [this, &min_buckets](uint64_t worker)
+            {
+                for (std::pair<int64_t, uint64_t> const& entry : _workers[worker].overflow)
+                {
+                    min_buckets[worker] = std::min(min_buckets[worker], entry.second);
+                }
+            }
+        );
+        uint64_t first = *std::min_element(min_buckets.begin(), min_buckets.end());
+        if (first == UINT64_MAX)
+        {
+            return false;
+        }
+        _first = first;
+        pasl::pctl::parallel_for(
+            static_cast<uint64_t>(0), workers_count,
+            [this](uint64_t worker)
+            {
+                return static_cast<uint64_t>(_workers[worker].overflow.size()) + 1;
+            },
+            [this](uint64_t worker)
+            {
+                worker_slots& slots = _workers[worker];
+                uint64_t kept = 0;
+                for (std::pair<int64_t, uint64_t> const& entry : slots.overflow)
+                {
+                    if (entry.second - _first < _ring_size)
+                    {
+                        slots.ring[entry.second % _ring_size].push_back(entry.first);
+                    }
+                    else
+                    {
+                        slots.overflow[kept++] = entry;
+                    }
+                }
+                slots.overflow.resize(kept);
+            }
+        );
+        return true;
+    }
+
+    // aligned, so that lists of different workers do not share cache lines
+    struct alignas(64) worker_slots
+    {
+        worker_slots(uint64_t ring_size) : ring(ring_size)
+        {
+        }
+
+        std::vector<std::vector<int64_t>>         ring;
+        std::vector<std::pair<int64_t, uint64_t>> overflow;
+    };
+
+    std::vector<worker_slots> _workers;
+    std::vector<uint64_t>     _offsets;
+    uint64_t                  _ring_size;
+    uint64_t                  _first;
+};
+
+/*
+Entries of the bucket, whose distances are still in it, without duplicates
+*/
+inline pasl::pctl::parray<int64_t> take_bucket_nodes(
+    delta_stepping_buckets& buckets, uint64_t bucket, int64_t delta,
+    pasl::pctl::parray<int64_t> const& dists, pasl::pctl::parray<uint64_t>& stamps, uint64_t round)
+{
+    pasl::pctl::parray<int64_t> entries = buckets.take(bucket);
+    pasl::pctl::parray<int64_t> claimed(
+        entries.size(),
+        [&entries, &dists, &stamps, bucket, delta, round](long entry_idx)
+        {
+            int64_t node = entries[entry_idx];
+            if (static_cast<uint64_t>(dists[node] / delta) != bucket || !claim_node(stamps, node, round))
+            {
+                return static_cast<int64_t>(-1);
+            }
+            return node;
+        }
+    );
+    return pasl::pctl::filter(
+        claimed.begin(), claimed.end(),
+        [](int64_t node)
+        {
+            return node != -1;
+        }
+    );
+}
+
+/*
+Relaxes light or heavy edges of the nodes, improved nodes are added to the buckets of their new distances.
+No new frontier is built, so this is a plain parallel loop over the edges of the nodes.
+*/
+template <typename V, typename W>
+void relax_edges(
+    weighted_csr_graph<V, W> const& graph, pasl::pctl::parray<int64_t> const& nodes, int64_t delta, bool light,
+    pasl::pctl::parray<int64_t>& dists, delta_stepping_buckets& buckets)
+{
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes.size(),
+        [&graph, &nodes](long node_idx)
+        {
+            return graph.degree(nodes[node_idx]) + 1;
+        },
+        [&graph, &nodes, delta, light, &dists, &buckets](long node_idx)
+        {
+            uint64_t from_node = static_cast<uint64_t>(nodes[node_idx]);
+            int64_t dist = __atomic_load_n(&dists[from_node], __ATOMIC_RELAXED);
+            pasl::pctl::parallel_for(
+                static_cast<uint64_t>(0), graph.degree(from_node),
+                [&graph, delta, light, &dists, &buckets, from_node, dist](uint64_t edge_idx)
+                {
+                    int64_t weight = static_cast<int64_t>(graph.weight(from_node, edge_idx));
+                    if ((weight <= delta) != light)
+                    {
+                        return;
+                    }
+                    uint64_t to_node = static_cast<uint64_t>(graph.neighbor(from_node, edge_idx));
+                    if (atomic_min(&dists[to_node], dist + weight))
+                    {
+                        buckets.add(to_node, static_cast<uint64_t>((dist + weight) / delta));
+                    }
+                }
+            );
+        }
+    );
+}
+
+/*
+Nodes of all parts in one array
+*/
+inline pasl::pctl::parray<int64_t> concat_nodes(std::vector<pasl::pctl::parray<int64_t>> const& parts)
+{
+    std::vector<uint64_t> offsets(parts.size() + 1, 0);
+    for (uint64_t part_idx = 0; part_idx < parts.size(); ++part_idx)
+    {
+        offsets[part_idx + 1] = offsets[part_idx] + static_cast<uint64_t>(parts[part_idx].size());
+    }
+    pasl::pctl::parray<int64_t> result(static_cast<long>(offsets.back()));
+    for (uint64_t part_idx = 0; part_idx < parts.size(); ++part_idx)
+    {
+        pasl::pctl::parray<int64_t> const& part = parts[part_idx];
+        uint64_t offset = offsets[part_idx];
+        pasl::pctl::parallel_for(
+            static_cast<long>(0), part.size(),
+            [&part, &result, offset](long node_idx)
+            {
+                result[offset + node_idx] = part[node_idx];
+            }
+        );
+    }
+    return result;
+}
+
+uint64_t const DELTA_STEPPING_MAX_RING_SIZE = 1 << 10;
+
+template <typename V, typename W>
+pasl::pctl::parray<int64_t> sssp_delta_stepping(
+    uint64_t nodes_count, uint64_t start_node, weighted_csr_graph<V, W> const& graph, int64_t delta)
+{
+    assert(start_node < nodes_count);
+    assert(delta > 0);
+    pasl::pctl::parray<W> const& weights = graph.get_weights();
+    W max_weight = pasl::pctl::reduce(
+        weights.begin(), weights.end(), static_cast<W>(0),
+        [](W x, W y)
+        {
+            return std::max(x, y);
+        }
+    );
+    delta_stepping_buckets buckets(
+        std::min(static_cast<uint64_t>(max_weight) / static_cast<uint64_t>(delta) + 2, DELTA_STEPPING_MAX_RING_SIZE)
+    );
+    pasl::pctl::parray<int64_t> dists(static_cast<long>(nodes_count), INT64_MAX);
+    pasl::pctl::parray<uint64_t> stamps(static_cast<long>(nodes_count), static_cast<uint64_t>(0));
+    uint64_t round = 0;
+    dists[start_node] = 0;
+    buckets.add(start_node, 0);
+
+    for (uint64_t cur_bucket = buckets.next_bucket(0); cur_bucket != UINT64_MAX;
+        cur_bucket = buckets.next_bucket(cur_bucket + 1))
+    {
+        // nodes may be settled several times, if their distances decrease inside the bucket
+        std::vector<pasl::pctl::parray<int64_t>> settled_parts;
+        while (true)
+        {
+            pasl::pctl::parray<int64_t> bucket_nodes = take_bucket_nodes(
+                buckets, cur_bucket, delta, dists, stamps, ++round
+            );
+            if (bucket_nodes.size() == 0)
+            {
+                break;
+            }
+            relax_edges(graph, bucket_nodes, delta, true, dists, buckets);
+            settled_parts.push_back(std::move(bucket_nodes));
+        }
+        pasl::pctl::parray<int64_t> settled = unique_nodes(concat_nodes(settled_parts), stamps, ++round);
+        relax_edges(graph, settled, delta, false, dists, buckets);
+    }
+
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), static_cast<long>(nodes_count),
+        [&dists](long node)
+        {
+            if (dists[node] == INT64_MAX)
+            {
+                dists[node] = -1;
+            }
+        }
+    );
+    return dists;
+}
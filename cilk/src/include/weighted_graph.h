@@ -0,0 +1,142 @@
+#pragma once
+
+#include "parray.hpp"
+#include "datapar.hpp"
+#include "graph.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include <cstdint>
+#include <cassert>
+#include <array>
+#include <algorithm>
+#include <utility>
+
+/*
+CSR with a weight for every edge: weights are stored in the same order as edges,
+so the weight of edge edge_idx of node v is weights[offsets[v] + edge_idx]
+*/
+template <typename V, typename W>
+struct weighted_csr_graph
+{
+public:
+    weighted_csr_graph(csr_graph<V>&& graph, pasl::pctl::parray<W>&& weights) :
+        _graph(std::move(graph)),
+        _weights(std::move(weights))
+    {
+        assert(static_cast<uint64_t>(_weights.size()) == _graph.edges_count());
+    }
+
+    uint64_t nodes_count() const
+    {
+        return _graph.nodes_count();
+    }
+
+    uint64_t edges_count() const
+    {
+        return _graph.edges_count();
+    }
+
+    uint64_t degree(uint64_t node) const
+    {
+        return _graph.degree(node);
+    }
+
+    V neighbor(uint64_t node, uint64_t edge_idx) const
+    {
+        return _graph.neighbor(node, edge_idx);
+    }
+
+    W weight(uint64_t node, uint64_t edge_idx) const
+    {
+        assert(edge_idx < degree(node));
+        return _weights[_graph.get_offsets()[node] + edge_idx];
+    }
+
+    csr_graph<V> const& get_graph() const
+    {
+        return _graph;
+    }
+
+    pasl::pctl::parray<W> const& get_weights() const
+    {
+        return _weights;
+    }
+private:
+    csr_graph<V>          _graph;
+    pasl::pctl::parray<W> _weights;
+};
+
+template <typename V, typename W>
+uint64_t node_degree(weighted_csr_graph<V, W> const& graph, uint64_t node)
+{
+    return graph.degree(node);
+}
+
+template <typename V, typename W>
+uint64_t node_neighbor(weighted_csr_graph<V, W> const& graph, uint64_t node, uint64_t edge_idx)
+{
+    return static_cast<uint64_t>(graph.neighbor(node, edge_idx));
+}
+
+template <typename V, typename W, typename F>
+void for_each_neighbor(weighted_csr_graph<V, W> const& graph, uint64_t node, F&& f)
+{
+    for_each_neighbor(graph.get_graph(), node, f);
+}
+
+template <typename V, typename W, typename F>
+void for_each_neighbor_until(weighted_csr_graph<V, W> const& graph, uint64_t node, F&& f)
+{
+    for_each_neighbor_until(graph.get_graph(), node, f);
+}
+
+template <typename V, typename W, typename F>
+void for_each_neighbor_range(weighted_csr_graph<V, W> const& graph, uint64_t node, uint64_t first, uint64_t last, F&& f)
+{
+    for_each_neighbor_range(graph.get_graph(), node, first, last, f);
+}
+
+template <typename V, typename W>
+uint64_t graph_memory_bytes(weighted_csr_graph<V, W> const& graph)
+{
+    return graph_memory_bytes(graph.get_graph()) + graph.edges_count() * sizeof(W);
+}
+
+/*
+Random weights from [1, max_weight]. The weight depends only on the pair of nodes,
+so both directions of an undirected edge get the same weight.
+*/
+template <typename V, typename W>
+weighted_csr_graph<V, W> add_random_weights(csr_graph<V>&& graph, W max_weight, uint64_t seed)
+{
+    assert(max_weight > 0);
+    long nodes_count = static_cast<long>(graph.nodes_count());
+    pasl::pctl::parray<W> weights(static_cast<long>(graph.edges_count()));
+    pasl::pctl::parallel_for(
+        static_cast<long>(0), nodes_count,
+        [&graph](long node)
+        {
+            return graph.degree(node) + 1;
+        },
+        [&graph, &weights, max_weight, seed](long from_node)
+        {
+            uint64_t first_edge = graph.get_offsets()[from_node];
+            for (uint64_t edge_idx = 0; edge_idx < graph.degree(from_node); ++edge_idx)
+            {
+                uint64_t to_node = static_cast<uint64_t>(graph.neighbor(from_node, edge_idx));
+                uint64_t hash = random_hash(
+                    seed, std::min<uint64_t>(from_node, to_node), std::max<uint64_t>(from_node, to_node)
+                );
+                weights[first_edge + edge_idx] = static_cast<W>(hash % max_weight + 1);
+            }
+        }
+    );
+    return weighted_csr_graph<V, W>(std::move(graph), std::move(weights));
+}
+
+template <typename V, typename W, std::size_t DIM>
+weighted_csr_graph<V, W> build_weighted_grid_graph(
+    std::array<uint64_t, DIM> const& dimensions, W max_weight, uint64_t seed)
+{
+    return add_random_weights(build_csr_graph<V>(dimensions), max_weight, seed);
+}
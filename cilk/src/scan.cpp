@@ -3,7 +3,7 @@
 #include "scan.h"
 #include <cassert>
 
-int32_t scan_exclusive_sequential_inplace(raw_array<int32_t>& x)
+int32_t scan_exclusive_sequential_inplace(array_view<int32_t> x)
 {
     if (x.size() == 0)
     {
@@ -20,7 +20,7 @@ int32_t scan_exclusive_sequential_inplace(raw_array<int32_t>& x)
     return x[x.size() - 1] + t;
 }
 
-std::pair<raw_array<int32_t>, int32_t> scan_exclusive_sequential(raw_array<int32_t> const& x)
+std::pair<raw_array<int32_t>, int32_t> scan_exclusive_sequential(array_view<int32_t const> x)
 {
     if (x.size() == 0)
     {
@@ -36,7 +36,7 @@ std::pair<raw_array<int32_t>, int32_t> scan_exclusive_sequential(raw_array<int32
     return {std::move(psums), total_sum};
 }
 
-std::pair<raw_array<int32_t>, int32_t> scan_exclusive_blocked(raw_array<int32_t> const& x, uint32_t blocks_count)
+std::pair<raw_array<int32_t>, int32_t> scan_exclusive_blocked(array_view<int32_t const> x, uint32_t blocks_count)
 {
     if (x.size() == 0)
     {
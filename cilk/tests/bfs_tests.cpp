@@ -1,2 +1,17 @@
 #include "test_graph_builder.h"
-#include "test_bfs_cube.h"
\ No newline at end of file
+#include "test_csr_graph.h"
+#include "test_bfs_cube.h"
+#include "test_graph_io.h"
+#include "test_compressed_graph.h"
+#include "test_graph_generators.h"
+#include "test_graph_reorder.h"
+#include "test_grid_layout.h"
+#include "test_frontier.h"
+#include "test_bfs_validation.h"
+#include "test_ms_bfs.h"
+#include "test_bidirectional_bfs.h"
+#include "test_connected_components.h"
+#include "test_sssp.h"
+#include "test_dynamic_bfs.h"
+#include "test_pagerank.h"
+#include "test_graph_transpose.h"
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "array_view.h"
+#include "map_parallel.h"
+#include "filter_parallel.h"
+#include "scan.h"
+#include "sort.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "constants.h"
+
+TEST(array_view, slicing)
+{
+    raw_array<int32_t> arr = raw_array<int32_t>::iota(100, 0);
+    array_view<int32_t> view(arr);
+    ASSERT_EQ(arr.get_raw_ptr(), view.get_raw_ptr());
+    ASSERT_EQ(100, view.size());
+
+    array_view<int32_t> slice = view.slice(10, 30);
+    ASSERT_EQ(20, slice.size());
+    ASSERT_EQ(10, slice[0]);
+    array_view<int32_t> inner = slice.slice(5, 10);
+    ASSERT_EQ(5, inner.size());
+    ASSERT_EQ(15, inner[0]);
+
+    inner[0] = -1;
+    ASSERT_EQ(-1, arr[15]);
+
+    array_view<int32_t const> const_view = inner;
+    ASSERT_EQ(-1, const_view[0]);
+    ASSERT_EQ(0, view.slice(100, 100).size());
+}
+
+TEST(array_view, vector_view)
+{
+    std::vector<int32_t> v({1, 2, 3});
+    array_view<int32_t> view(v);
+    view[1] = 5;
+    ASSERT_EQ(5, v[1]);
+    std::vector<int32_t> const& cv = v;
+    array_view<int32_t const> const_view(cv);
+    ASSERT_EQ(3, const_view.size());
+}
+
+TEST(array_view, primitives_on_slices)
+{
+    raw_array<int32_t> arr = raw_array<int32_t>::iota(1000, 0);
+    array_view<int32_t const> slice = array_view<int32_t>(arr).slice(100, 200);
+
+    raw_array<int32_t> mapped = map_parallel<int32_t, int32_t>(slice, [](int32_t const& x) { return x * 2; }, 7);
+    ASSERT_EQ(100, mapped.size());
+    for (uint32_t i = 0; i < mapped.size(); ++i)
+    {
+        ASSERT_EQ(2 * (100 + i), mapped[i]);
+    }
+
+    raw_array<int32_t> filtered = filter_parallel<int32_t>(slice, [](int32_t const& x) { return x % 3 == 0; }, 7);
+    ASSERT_EQ(33, filtered.size());
+    for (uint32_t i = 0; i < filtered.size(); ++i)
+    {
+        ASSERT_EQ(102 + 3 * i, filtered[i]);
+    }
+
+    auto [psums, total_sum] = scan_exclusive_blocked(slice, 7);
+    ASSERT_EQ(100, psums.size());
+    ASSERT_EQ(0, psums[0]);
+    ASSERT_EQ(100, psums[1]);
+    ASSERT_EQ(14950, total_sum);
+
+    raw_array<int32_t> dst(1000, 0);
+    copy_parallel<int32_t>(slice, array_view<int32_t>(dst).slice(0, 100), 7);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(100 + i, dst[i]);
+    }
+    ASSERT_EQ(0, dst[100]);
+}
+
+TEST(array_view, sort_slice)
+{
+    std::default_random_engine generator(time(nullptr));
+    std::uniform_int_distribution<int32_t> elements_distribution(-1000000, 1000000);
+
+    for (uint32_t i = 0; i < TESTS_COUNT / 10; ++i)
+    {
+        raw_array<int32_t> arr(10000);
+        for (uint32_t j = 0; j < arr.size(); ++j)
+        {
+            arr[j] = elements_distribution(generator);
+        }
+        raw_array<int32_t> initial(arr);
+        sort_parallel(array_view<int32_t>(arr).slice(1000, 9000), 50);
+
+        std::vector<int32_t> expected(initial.begin(), initial.end());
+        std::sort(expected.begin() + 1000, expected.begin() + 9000);
+        for (uint32_t j = 0; j < arr.size(); ++j)
+        {
+            ASSERT_EQ(expected[j], arr[j]);
+        }
+    }
+}
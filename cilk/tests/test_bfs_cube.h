@@ -5,8 +5,10 @@
 #include <gtest/gtest.h>
 #include <cstdint>
 #include "bfs.h"
+#include "compressed_graph.h"
 #include <vector>
 #include <functional>
+#include <type_traits>
 
 template <std::size_t DIM>
 void do_get_all_points(
@@ -57,12 +59,14 @@ uint64_t get_dist(std::array<uint64_t, DIM> const& pt_a, std::array<uint64_t, DI
     return result;
 }
 
-template <template <typename, typename ...> typename C, std::size_t DIM>
+/*
+D is the distance type, it is not deduced from bfs_fun, so lambdas can be passed directly
+*/
+template <template <typename, typename ...> typename C, std::size_t DIM, typename Graph, typename D = int64_t>
 void test_bfs_cubic(
-    std::array<uint64_t, DIM> const& dimensions,
-    std::function<C<int64_t>(uint64_t, uint64_t, std::vector<std::vector<uint64_t>> const&)> const& bfs_fun)
+    std::array<uint64_t, DIM> const& dimensions, Graph const& edges,
+    std::function<C<typename std::decay<D>::type>(uint64_t, uint64_t, Graph const&)> const& bfs_fun)
 {
-    auto edges = build_graph(dimensions);
     uint64_t nodes_count = calc_nodes_count(dimensions);
     auto all_points = get_all_points(dimensions);
     assert(all_points.size() == nodes_count);
@@ -70,8 +74,8 @@ void test_bfs_cubic(
     for (auto const& start_point : all_points)
     {
         uint64_t start_idx = coords_to_index(start_point, dimensions);
-        C<int64_t> result = bfs_fun(nodes_count, start_idx, edges);
-        assert(result.size() == nodes_count);
+        C<D> result = bfs_fun(nodes_count, start_idx, edges);
+        assert(static_cast<uint64_t>(result.size()) == nodes_count);
 
         for (uint64_t i = 0; i < nodes_count; ++i)
         {
@@ -81,34 +85,53 @@ void test_bfs_cubic(
     }
 }
 
+template <std::size_t DIM>
+void test_sequential_bfs(std::array<uint64_t, DIM> const& dims)
+{
+    test_bfs_cubic<std::vector, DIM, adjacency_list>(
+        dims, build_graph(dims), bfs_sequential<adjacency_list>
+    );
+    test_bfs_cubic<std::vector, DIM, csr_graph<uint64_t>>(
+        dims, build_csr_graph<uint64_t>(dims), bfs_sequential<csr_graph<uint64_t>>
+    );
+    test_bfs_cubic<std::vector, DIM, csr_graph<uint32_t>>(
+        dims, build_csr_graph<uint32_t>(dims), bfs_sequential<csr_graph<uint32_t>>
+    );
+    test_bfs_cubic<std::vector, DIM, grid_graph<DIM>>(
+        dims, grid_graph<DIM>(dims), bfs_sequential<grid_graph<DIM>>
+    );
+    test_bfs_cubic<std::vector, DIM, compressed_graph>(
+        dims, compress_graph(build_csr_graph<uint32_t>(dims)), bfs_sequential<compressed_graph>
+    );
+}
+
 TEST(sequential_bfs, stress_two_dimensions)
 {
     std::array<uint64_t, 2> dims = {10, 20};
-    test_bfs_cubic<std::vector, 2>(dims, bfs_sequential);
+    test_sequential_bfs<2>(dims);
 }
 
 TEST(sequential_bfs, stress_three_dimensions)
 {
     std::array<uint64_t, 3> dims = {3, 10, 5};
-    test_bfs_cubic<std::vector, 3>(dims, bfs_sequential);
+    test_sequential_bfs<3>(dims);
 }
 
-template <std::size_t DIM>
-void test_cas_bfs(std::array<uint64_t, DIM> const& dims)
+template <std::size_t DIM, typename Graph>
+void test_cas_bfs(std::array<uint64_t, DIM> const& dims, Graph const& edges)
 {
     std::vector<NodeLoopType> all_loop_types({
-        NodeLoopType::NonRange, NodeLoopType::NonRangeCost, NodeLoopType::Range
+        NodeLoopType::NonRange, NodeLoopType::NonRangeCost, NodeLoopType::Range, NodeLoopType::EdgeBalanced
     });
     std::vector<bool> all_bools({false, true});
     for (NodeLoopType cur_loop_type : all_loop_types)
     {
         for (bool process_edges_in_parallel : all_bools)
         {
-            test_bfs_cubic<pasl::pctl::parray, DIM>(
-                dims, 
+            test_bfs_cubic<pasl::pctl::parray, DIM, Graph>(
+                dims, edges,
                 [cur_loop_type, process_edges_in_parallel](
-                    uint64_t nodes_count, uint64_t start_node,
-                    std::vector<std::vector<uint64_t>> const& edges)
+                    uint64_t nodes_count, uint64_t start_node, Graph const& edges)
                 {
                     return bfs_cas(
                         nodes_count, start_node, edges, 
@@ -120,6 +143,67 @@ void test_cas_bfs(std::array<uint64_t, DIM> const& dims)
     }
 }
 
+template <std::size_t DIM, typename Graph>
+void test_direction_optimizing_bfs(std::array<uint64_t, DIM> const& dims, Graph const& edges)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> all_params({{15, 18}, {1, 1}, {UINT64_MAX, UINT64_MAX}});
+    for (auto [alpha, beta] : all_params)
+    {
+        test_bfs_cubic<pasl::pctl::parray, DIM, Graph>(
+            dims, edges,
+            [alpha = alpha, beta = beta](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+            {
+                return bfs_direction_optimizing(nodes_count, start_node, edges, alpha, beta);
+            }
+        );
+    }
+}
+
+template <std::size_t DIM, typename Graph>
+void test_adaptive_bfs(std::array<uint64_t, DIM> const& dims, Graph const& edges)
+{
+    bfs_frontier frontier(calc_nodes_count(dims));
+    for (VisitMarking marking : {VisitMarking::SeqCstCas, VisitMarking::TestAndCas})
+    {
+        test_bfs_cubic<pasl::pctl::parray, DIM, Graph>(
+            dims, edges,
+            [&frontier, marking](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+            {
+                return bfs_cas_adaptive(nodes_count, start_node, edges, frontier, marking);
+            }
+        );
+    }
+    test_bfs_cubic<pasl::pctl::parray, DIM, Graph, int32_t>(
+        dims, edges,
+        [&frontier](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+        {
+            return bfs_visited_bitset(nodes_count, start_node, edges, frontier);
+        }
+    );
+    worker_frontier local_frontier;
+    test_bfs_cubic<pasl::pctl::parray, DIM, Graph>(
+        dims, edges,
+        [&local_frontier](uint64_t nodes_count, uint64_t start_node, Graph const& edges)
+        {
+            return bfs_worker_buffers(nodes_count, start_node, edges, local_frontier);
+        }
+    );
+}
+
+template <std::size_t DIM>
+void test_cas_bfs(std::array<uint64_t, DIM> const& dims)
+{
+    test_direction_optimizing_bfs(dims, build_csr_graph<uint32_t>(dims));
+    test_direction_optimizing_bfs(dims, grid_graph<DIM>(dims));
+    test_adaptive_bfs(dims, build_csr_graph<uint32_t>(dims));
+    test_adaptive_bfs(dims, grid_graph<DIM>(dims));
+    test_cas_bfs(dims, build_graph(dims));
+    test_cas_bfs(dims, build_csr_graph<uint64_t>(dims));
+    test_cas_bfs(dims, build_csr_graph<uint32_t>(dims));
+    test_cas_bfs(dims, grid_graph<DIM>(dims));
+    test_cas_bfs(dims, compress_graph(build_csr_graph<uint32_t>(dims)));
+}
+
 TEST(cas_bfs, stress_two_dimensions)
 {
     std::array<uint64_t, 2> dims = {10, 20};
@@ -130,4 +214,4 @@ TEST(cas_bfs, stress_three_dimensions)
 {
     std::array<uint64_t, 3> dims = {5, 10, 20};
     test_cas_bfs<3>(dims);
-}
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "bfs.h"
+#include "bfs_validation.h"
+#include "graph_builder.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+TEST(bfs_validation, correct_results)
+{
+    std::array<uint64_t, 3> dims = {7, 5, 6};
+    uint64_t nodes_count = calc_nodes_count(dims);
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    for (uint64_t start_node : {static_cast<uint64_t>(0), nodes_count / 2, nodes_count - 1})
+    {
+        pasl::pctl::parray<int64_t> parents = bfs_cas_parents(nodes_count, start_node, graph);
+        ASSERT_EQ(BfsValidationError::None, validate_bfs_tree(nodes_count, start_node, graph, parents));
+
+        pasl::pctl::parray<int64_t> dists = bfs_cas(nodes_count, start_node, graph, NodeLoopType::Range, false);
+        ASSERT_EQ(BfsValidationError::None, validate_bfs_distances(nodes_count, start_node, graph, dists));
+    }
+}
+
+TEST(bfs_validation, wrong_trees)
+{
+    // triangle 0, 1, 2, node 3 hangs on node 2, node 4 is isolated
+    adjacency_list graph({{1, 2}, {0, 2}, {0, 1, 3}, {2}, {}});
+    auto validate = [&graph](std::vector<int64_t> const& parents)
+    {
+        pasl::pctl::parray<int64_t> result(
+            static_cast<long>(parents.size()),
+            [&parents](long node)
+            {
+                return parents[node];
+            }
+        );
+        return validate_bfs_tree(graph.size(), 0, graph, result);
+    };
+
+    ASSERT_EQ(BfsValidationError::None, validate({0, 0, 0, 2, -1}));
+    ASSERT_EQ(BfsValidationError::WrongStart, validate({1, 0, 0, 2, -1}));
+    ASSERT_EQ(BfsValidationError::NotATree, validate({0, 2, 1, 2, -1}));
+    ASSERT_EQ(BfsValidationError::NotATree, validate({0, 0, 0, 2, 4}));
+    ASSERT_EQ(BfsValidationError::NotATree, validate({0, 0, 0, 7, -1}));
+    ASSERT_EQ(BfsValidationError::MissingTreeEdge, validate({0, 0, 0, 1, -1}));
+    ASSERT_EQ(BfsValidationError::WrongLevel, validate({0, 0, 1, 2, -1}));
+    ASSERT_EQ(BfsValidationError::Unreached, validate({0, 0, 0, -1, -1}));
+}
+
+TEST(bfs_validation, wrong_distances)
+{
+    adjacency_list graph({{1, 2}, {0, 2}, {0, 1, 3}, {2}, {}});
+    auto validate = [&graph](std::vector<int64_t> const& dists)
+    {
+        return validate_bfs_distances(graph.size(), 0, graph, dists);
+    };
+
+    ASSERT_EQ(BfsValidationError::None, validate({0, 1, 1, 2, -1}));
+    ASSERT_EQ(BfsValidationError::WrongStart, validate({1, 1, 1, 2, -1}));
+    ASSERT_EQ(BfsValidationError::WrongStart, validate({0, 0, 1, 2, -1}));
+    ASSERT_EQ(BfsValidationError::WrongLevel, validate({0, 1, 2, 3, -1}));
+    ASSERT_EQ(BfsValidationError::WrongLevel, validate({0, 1, 1, 2, 1}));
+    ASSERT_EQ(BfsValidationError::WrongLevel, validate({0, 2, 1, 2, -1}));
+    ASSERT_EQ(BfsValidationError::Unreached, validate({0, 1, 1, -1, -1}));
+}
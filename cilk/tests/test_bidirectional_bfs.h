@@ -0,0 +1,73 @@
+#pragma once
+
+#include "bidirectional_bfs.h"
+#include "bfs.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+TEST(bidirectional_bfs, node_map)
+{
+    concurrent_node_map map(4);
+    for (uint64_t node = 0; node < 1000; ++node)
+    {
+        map.reserve(node + 1);
+        ASSERT_TRUE(map.insert(node * 7, static_cast<int64_t>(node)));
+        ASSERT_FALSE(map.insert(node * 7, 0));
+    }
+    ASSERT_LE(2000, map.capacity());
+    for (uint64_t node = 0; node < 7000; ++node)
+    {
+        ASSERT_EQ(node % 7 == 0 ? static_cast<int64_t>(node / 7) : -1, map.find(node));
+    }
+}
+
+TEST(bidirectional_bfs, grid)
+{
+    std::array<uint64_t, 3> dims = {6, 7, 8};
+    uint64_t nodes_count = calc_nodes_count(dims);
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    for (uint64_t start_node = 0; start_node < nodes_count; start_node += 13)
+    {
+        std::vector<int64_t> expected = bfs_sequential(nodes_count, start_node, graph);
+        for (uint64_t target_node = 0; target_node < nodes_count; ++target_node)
+        {
+            ASSERT_EQ(expected[target_node], bfs_bidirectional(nodes_count, start_node, target_node, graph));
+        }
+    }
+}
+
+TEST(bidirectional_bfs, generated_graph)
+{
+    csr_graph<uint32_t> graph = generate_rmat_graph<uint32_t>(10, 4, 42);
+    uint64_t nodes_count = graph.nodes_count();
+    for (uint64_t query = 0; query < 20; ++query)
+    {
+        uint64_t start_node = random_hash(42, query) % nodes_count;
+        std::vector<int64_t> expected = bfs_sequential(nodes_count, start_node, graph);
+        for (uint64_t target_node = 0; target_node < nodes_count; ++target_node)
+        {
+            ASSERT_EQ(expected[target_node], bfs_bidirectional(nodes_count, start_node, target_node, graph));
+        }
+    }
+}
+
+TEST(bidirectional_bfs, directed_graph)
+{
+    adjacency_list out_edges({{1, 4}, {2}, {3}, {0}, {3}, {}});
+    adjacency_list in_edges({{3}, {0}, {1}, {2, 4}, {0}, {}});
+    for (uint64_t start_node = 0; start_node < out_edges.size(); ++start_node)
+    {
+        std::vector<int64_t> expected = bfs_sequential(out_edges.size(), start_node, out_edges);
+        for (uint64_t target_node = 0; target_node < out_edges.size(); ++target_node)
+        {
+            ASSERT_EQ(
+                expected[target_node],
+                bfs_bidirectional(out_edges.size(), start_node, target_node, out_edges, in_edges)
+            );
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "compressed_graph.h"
+#include "graph_builder.h"
+#include "test_csr_graph.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <random>
+#include <algorithm>
+
+TEST(compressed_graph, varint)
+{
+    std::vector<uint64_t> values({0, 1, 127, 128, 300, 16383, 16384, UINT32_MAX, UINT64_MAX});
+    std::vector<uint8_t> bytes(10 * values.size());
+    uint8_t* dst = bytes.data();
+    for (uint64_t value : values)
+    {
+        uint8_t* end = encode_varint(dst, value);
+        ASSERT_EQ(varint_size(value), static_cast<uint64_t>(end - dst));
+        dst = end;
+    }
+    uint8_t const* src = bytes.data();
+    for (uint64_t value : values)
+    {
+        ASSERT_EQ(value, decode_varint(src));
+    }
+    ASSERT_EQ(dst, src);
+}
+
+TEST(compressed_graph, zigzag)
+{
+    std::vector<int64_t> values({0, -1, 1, -2, 2, INT32_MIN, INT64_MIN, INT64_MAX});
+    for (int64_t value : values)
+    {
+        ASSERT_EQ(value, zigzag_decode(zigzag_encode(value)));
+    }
+    ASSERT_EQ(1, zigzag_encode(-1));
+    ASSERT_EQ(2, zigzag_encode(1));
+}
+
+TEST(compressed_graph, random_graph)
+{
+    std::default_random_engine generator(42);
+    std::uniform_int_distribution<uint64_t> node_distribution(0, 9999);
+    std::uniform_int_distribution<uint64_t> degree_distribution(0, 20);
+    adjacency_list edges(10000);
+    for (std::vector<uint64_t>& to_nodes : edges)
+    {
+        uint64_t degree = degree_distribution(generator);
+        for (uint64_t i = 0; i < degree; ++i)
+        {
+            to_nodes.push_back(node_distribution(generator));
+        }
+        std::sort(to_nodes.begin(), to_nodes.end());
+    }
+    check_same_graph(edges, compress_graph(adjacency_list_to_csr<uint32_t>(edges)));
+}
+
+TEST(compressed_graph, cube)
+{
+    std::array<uint64_t, 3> dims = {10, 20, 30};
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    compressed_graph compressed = compress_graph(graph);
+    adjacency_list edges = build_graph(dims);
+    for (std::vector<uint64_t>& to_nodes : edges)
+    {
+        std::sort(to_nodes.begin(), to_nodes.end());
+    }
+    check_same_graph(edges, compressed);
+    ASSERT_LT(graph_memory_bytes(compressed), graph_memory_bytes(graph));
+}
+
+TEST(compressed_graph, empty_graph)
+{
+    compressed_graph graph = compress_graph(adjacency_list_to_csr<uint64_t>(adjacency_list()));
+    ASSERT_EQ(0, graph.nodes_count());
+    ASSERT_EQ(0, graph.edges_count());
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "connected_components.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include "compressed_graph.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+template <typename Graph>
+void check_connected_components(uint64_t nodes_count, Graph const& edges)
+{
+    connected_components expected = connected_components_sequential(nodes_count, edges);
+    connected_components result = connected_components_union_find(nodes_count, edges);
+    ASSERT_EQ(nodes_count, result.labels.size());
+    ASSERT_EQ(expected.sizes.size(), result.sizes.size());
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        ASSERT_EQ(expected.labels[node], result.labels[node]);
+    }
+    for (long component = 0; component < expected.sizes.size(); ++component)
+    {
+        ASSERT_EQ(expected.sizes[component], result.sizes[component]);
+    }
+}
+
+TEST(connected_components, grid)
+{
+    std::array<uint64_t, 3> dims = {10, 11, 12};
+    uint64_t nodes_count = calc_nodes_count(dims);
+    check_connected_components(nodes_count, build_graph(dims));
+    check_connected_components(nodes_count, build_csr_graph<uint32_t>(dims));
+    check_connected_components(nodes_count, grid_graph<3>(dims));
+    check_connected_components(nodes_count, compress_graph(build_csr_graph<uint32_t>(dims)));
+    ASSERT_EQ(1, connected_components_union_find(nodes_count, grid_graph<3>(dims)).sizes.size());
+}
+
+TEST(connected_components, generated_graphs)
+{
+    // sparse graphs have many small components besides the giant one
+    for (uint64_t avg_degree : {1, 2, 4})
+    {
+        csr_graph<uint32_t> graph = generate_uniform_graph<uint32_t>(20000, avg_degree, 42);
+        check_connected_components(graph.nodes_count(), graph);
+    }
+    csr_graph<uint32_t> graph = generate_rmat_graph<uint32_t>(14, 4, 42);
+    check_connected_components(graph.nodes_count(), graph);
+}
+
+TEST(connected_components, directed_graph)
+{
+    // weakly connected components: {0, 1, 2}, {3, 4}, {5}
+    adjacency_list graph({{}, {0}, {1}, {}, {3}, {}});
+    connected_components result = connected_components_union_find(graph.size(), graph);
+    std::vector<uint64_t> expected_labels({0, 0, 0, 1, 1, 2});
+    std::vector<uint64_t> expected_sizes({3, 2, 1});
+    for (uint64_t node = 0; node < graph.size(); ++node)
+    {
+        ASSERT_EQ(expected_labels[node], result.labels[node]);
+    }
+    ASSERT_EQ(expected_sizes.size(), result.sizes.size());
+    for (uint64_t component = 0; component < expected_sizes.size(); ++component)
+    {
+        ASSERT_EQ(expected_sizes[component], result.sizes[component]);
+    }
+}
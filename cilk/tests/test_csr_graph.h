@@ -0,0 +1,134 @@
+#pragma once
+
+#include "graph.h"
+#include "graph_builder.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+template <typename Graph>
+void check_same_graph(adjacency_list const& edges, Graph const& graph)
+{
+    ASSERT_EQ(edges.size(), graph.nodes_count());
+    uint64_t edges_count = 0;
+    for (uint64_t node = 0; node < edges.size(); ++node)
+    {
+        ASSERT_EQ(edges[node].size(), node_degree(graph, node));
+        for (uint64_t edge_idx = 0; edge_idx < edges[node].size(); ++edge_idx)
+        {
+            ASSERT_EQ(edges[node][edge_idx], node_neighbor(graph, node, edge_idx));
+        }
+        std::vector<uint64_t> to_nodes;
+        for_each_neighbor(
+            graph, node,
+            [&to_nodes](uint64_t to_node)
+            {
+                to_nodes.push_back(to_node);
+            }
+        );
+        ASSERT_EQ(edges[node], to_nodes);
+
+        // stops after the middle neighbor
+        uint64_t stop_idx = edges[node].size() / 2;
+        std::vector<uint64_t> prefix;
+        for_each_neighbor_until(
+            graph, node,
+            [&prefix, stop_idx](uint64_t to_node)
+            {
+                prefix.push_back(to_node);
+                return prefix.size() == stop_idx + 1;
+            }
+        );
+        uint64_t prefix_size = std::min<uint64_t>(stop_idx + 1, edges[node].size());
+        ASSERT_EQ(std::vector<uint64_t>(edges[node].begin(), edges[node].begin() + prefix_size), prefix);
+
+        uint64_t first = edges[node].size() / 3;
+        uint64_t last = std::min<uint64_t>(2 * edges[node].size() / 3 + 1, edges[node].size());
+        std::vector<uint64_t> middle;
+        for_each_neighbor_range(
+            graph, node, first, last,
+            [&middle](uint64_t to_node)
+            {
+                middle.push_back(to_node);
+            }
+        );
+        ASSERT_EQ(std::vector<uint64_t>(edges[node].begin() + first, edges[node].begin() + last), middle);
+        edges_count += edges[node].size();
+    }
+    ASSERT_EQ(edges_count, graph.edges_count());
+}
+
+TEST(csr_graph, from_adjacency_list)
+{
+    adjacency_list edges({{1, 2}, {}, {0, 1, 3}, {3}});
+    check_same_graph(edges, adjacency_list_to_csr<uint64_t>(edges));
+    check_same_graph(edges, adjacency_list_to_csr<uint32_t>(edges));
+}
+
+TEST(csr_graph, empty_graph)
+{
+    adjacency_list edges;
+    csr_graph<uint32_t> graph = adjacency_list_to_csr<uint32_t>(edges);
+    ASSERT_EQ(0, graph.nodes_count());
+    ASSERT_EQ(0, graph.edges_count());
+}
+
+template <std::size_t DIM>
+void check_grid_csr(std::array<uint64_t, DIM> const& dims)
+{
+    adjacency_list edges = build_graph(dims);
+    for (std::vector<uint64_t>& to_nodes : edges)
+    {
+        std::sort(to_nodes.begin(), to_nodes.end());
+    }
+    check_same_graph(edges, build_csr_graph<uint64_t>(dims));
+    check_same_graph(edges, build_csr_graph<uint32_t>(dims));
+    check_same_graph(edges, grid_graph<DIM>(dims));
+}
+
+TEST(csr_graph, grid_one_dimensional)
+{
+    check_grid_csr<1>({1});
+    check_grid_csr<1>({10});
+}
+
+TEST(csr_graph, grid_two_dimensional)
+{
+    check_grid_csr<2>({10, 20});
+    check_grid_csr<2>({1, 7});
+}
+
+TEST(csr_graph, grid_three_dimensional)
+{
+    check_grid_csr<3>({10, 20, 30});
+    check_grid_csr<3>({2, 1, 5});
+}
+
+TEST(csr_graph, grid_four_dimensional)
+{
+    check_grid_csr<4>({3, 4, 5, 6});
+}
+
+TEST(csr_graph, index_to_coords)
+{
+    std::array<uint64_t, 3> dims = {10, 20, 30};
+    std::array<uint64_t, 3> elems_in_dim = calc_elems_in_dim(dims);
+    for (uint64_t i = 0; i < calc_nodes_count(dims); ++i)
+    {
+        ASSERT_EQ(i, coords_to_index(index_to_coords(i, dims, elems_in_dim), dims));
+    }
+}
+
+TEST(csr_graph, memory)
+{
+    std::array<uint64_t, 2> dims = {10, 20};
+    csr_graph<uint64_t> graph_64 = build_csr_graph<uint64_t>(dims);
+    csr_graph<uint32_t> graph_32 = build_csr_graph<uint32_t>(dims);
+    ASSERT_EQ(graph_64.edges_count(), graph_32.edges_count());
+    ASSERT_EQ(
+        graph_memory_bytes(graph_64) - graph_memory_bytes(graph_32), 
+        graph_64.edges_count() * sizeof(uint32_t)
+    );
+}
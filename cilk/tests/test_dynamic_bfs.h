@@ -0,0 +1,90 @@
+#pragma once
+
+#include "dynamic_bfs.h"
+#include "bfs.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <utility>
+
+void check_dynamic_bfs(dynamic_bfs const& bfs)
+{
+    std::vector<int64_t> expected = bfs_sequential(bfs.nodes_count(), bfs.get_start_node(), bfs.get_graph());
+    for (uint64_t node = 0; node < bfs.nodes_count(); ++node)
+    {
+        ASSERT_EQ(expected[node], bfs.get_distances()[node]);
+    }
+}
+
+TEST(dynamic_bfs, path)
+{
+    uint64_t nodes_count = 10;
+    adjacency_list edges(nodes_count);
+    for (uint64_t node = 0; node + 1 < nodes_count; ++node)
+    {
+        edges[node].push_back(node + 1);
+    }
+    edges[8].clear();
+    dynamic_bfs bfs(std::move(edges), 0, false);
+    ASSERT_EQ(-1, bfs.get_distances()[9]);
+
+    ASSERT_EQ(0, bfs.insert_edges({{3, 2}, {5, 5}}));
+    check_dynamic_bfs(bfs);
+    ASSERT_EQ(1, bfs.insert_edges({{8, 9}}));
+    check_dynamic_bfs(bfs);
+    // shortcut 0 -> 5 lowers nodes 5..9
+    ASSERT_EQ(5, bfs.insert_edges({{0, 5}}));
+    check_dynamic_bfs(bfs);
+    // the seed 7 is lowered by the seed 6 at an earlier level
+    bfs.insert_edges({{0, 6}, {1, 7}});
+    check_dynamic_bfs(bfs);
+}
+
+TEST(dynamic_bfs, random_batches)
+{
+    std::array<uint64_t, 2> dims = {30, 40};
+    uint64_t nodes_count = calc_nodes_count(dims);
+    dynamic_bfs bfs(build_graph(dims), nodes_count / 2, true);
+    for (uint64_t batch = 0; batch < 20; ++batch)
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> new_edges;
+        for (uint64_t edge_idx = 0; edge_idx <= batch; ++edge_idx)
+        {
+            new_edges.push_back({
+                random_hash(42, batch, 2 * edge_idx) % nodes_count, random_hash(42, batch, 2 * edge_idx + 1) % nodes_count
+            });
+        }
+        bfs.insert_edges(new_edges);
+        check_dynamic_bfs(bfs);
+    }
+}
+
+TEST(dynamic_bfs, disconnected_graph)
+{
+    csr_graph<uint32_t> graph = generate_uniform_graph<uint32_t>(2000, 1, 42);
+    adjacency_list edges(graph.nodes_count());
+    for (uint64_t node = 0; node < graph.nodes_count(); ++node)
+    {
+        for_each_neighbor(
+            graph, node,
+            [&edges, node](uint64_t to_node)
+            {
+                edges[node].push_back(to_node);
+            }
+        );
+    }
+    dynamic_bfs bfs(std::move(edges), 0, true);
+    for (uint64_t batch = 0; batch < 10; ++batch)
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> new_edges;
+        for (uint64_t edge_idx = 0; edge_idx < 50; ++edge_idx)
+        {
+            new_edges.push_back({random_hash(7, batch, 2 * edge_idx) % 2000, random_hash(7, batch, 2 * edge_idx + 1) % 2000});
+        }
+        bfs.insert_edges(new_edges);
+        check_dynamic_bfs(bfs);
+    }
+}
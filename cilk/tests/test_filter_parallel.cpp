@@ -5,6 +5,7 @@
 #include <vector>
 #include <functional>
 #include <cassert>
+#include <string>
 #include "constants.h"
 
 bool is_even(int32_t const& x)
@@ -143,4 +144,19 @@ TEST(parallel_filter, greater)
         return x > partitioner;
     };
     stress_partitioner(comp_gt);
-}
\ No newline at end of file
+}
+
+TEST(parallel_filter, move_strings)
+{
+    raw_array<std::string> arr(1000, [](uint32_t idx) { return std::to_string(idx); });
+    raw_array<std::string> res = filter_parallel_move<std::string>(
+        arr, [](std::string const& x) { return x.back() == '7'; }, 10
+    );
+    ASSERT_EQ(100, res.size());
+    for (uint32_t i = 0; i < res.size(); ++i)
+    {
+        ASSERT_EQ(std::to_string(i * 10 + 7), res[i]);
+        ASSERT_TRUE(arr[i * 10 + 7].empty());
+    }
+    ASSERT_EQ("8", arr[8]);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "frontier.h"
+#include "bfs.h"
+#include "graph_generators.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include <set>
+
+/*
+Two-level star: the center has many leaves, every leaf has one own leaf, so the frontier
+goes from one node to many nodes (dense) and back to a few nodes (sparse)
+*/
+TEST(frontier, dense_and_sparse)
+{
+    uint64_t leaves_count = 1000;
+    uint64_t nodes_count = 1 + 2 * leaves_count + 1;
+    adjacency_list edges(nodes_count);
+    for (uint64_t i = 1; i <= leaves_count; ++i)
+    {
+        edges[0].push_back(i);
+        edges[i].push_back(leaves_count + i);
+    }
+    edges[leaves_count + 1].push_back(nodes_count - 1);
+
+    std::vector<bool> visited(nodes_count, false);
+    visited[0] = true;
+    bfs_frontier frontier(nodes_count);
+    frontier.reset(0);
+
+    std::vector<uint64_t> expected_sizes({leaves_count, leaves_count, 1, 0});
+    for (uint64_t expected_size : expected_sizes)
+    {
+        frontier.advance(
+            edges,
+            [&visited](uint64_t, uint64_t to_node)
+            {
+                if (visited[to_node])
+                {
+                    return false;
+                }
+                visited[to_node] = true;
+                return true;
+            }
+        );
+        ASSERT_EQ(expected_size, frontier.size());
+        if (expected_size == leaves_count)
+        {
+            ASSERT_TRUE(frontier.is_dense());
+        }
+        else
+        {
+            ASSERT_FALSE(frontier.is_dense());
+        }
+    }
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        ASSERT_TRUE(visited[node]);
+    }
+}
+
+TEST(frontier, reuse)
+{
+    csr_graph<uint32_t> graph = generate_rmat_graph<uint32_t>(12, 8, 42);
+    bfs_frontier frontier(graph.nodes_count());
+    for (uint64_t start_node = 0; start_node < graph.nodes_count(); start_node += 501)
+    {
+        std::vector<int64_t> expected = bfs_sequential(graph.nodes_count(), start_node, graph);
+        pasl::pctl::parray<int64_t> result = bfs_cas_adaptive(graph.nodes_count(), start_node, graph, frontier);
+        for (uint64_t node = 0; node < graph.nodes_count(); ++node)
+        {
+            ASSERT_EQ(expected[node], result[node]);
+        }
+    }
+}
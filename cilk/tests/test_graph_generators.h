@@ -0,0 +1,173 @@
+#pragma once
+
+#include "graph_generators.h"
+#include "bfs.h"
+#include "bfs_validation.h"
+#include "test_graph_io.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+template <typename V>
+void check_undirected_graph(csr_graph<V> const& graph)
+{
+    adjacency_list edges = csr_to_adjacency_list(graph);
+    for (uint64_t node = 0; node < edges.size(); ++node)
+    {
+        std::vector<uint64_t> const& to_nodes = edges[node];
+        ASSERT_TRUE(std::adjacent_find(to_nodes.begin(), to_nodes.end(), std::greater_equal<uint64_t>()) == to_nodes.end());
+        for (uint64_t to_node : to_nodes)
+        {
+            ASSERT_NE(node, to_node);
+            ASSERT_TRUE(std::binary_search(edges[to_node].begin(), edges[to_node].end(), node));
+        }
+    }
+}
+
+template <typename V>
+void check_bfs_on_graph(csr_graph<V> const& graph)
+{
+    uint64_t nodes_count = graph.nodes_count();
+    std::vector<NodeLoopType> all_loop_types({
+        NodeLoopType::NonRange, NodeLoopType::NonRangeCost, NodeLoopType::Range, NodeLoopType::EdgeBalanced
+    });
+    for (NodeLoopType cur_loop_type : all_loop_types)
+    {
+        for (bool process_edges_in_parallel : {false, true})
+        {
+            pasl::pctl::parray<int64_t> result = bfs_cas(
+                nodes_count, 0, graph, cur_loop_type, process_edges_in_parallel
+            );
+            ASSERT_EQ(BfsValidationError::None, validate_bfs_distances(nodes_count, 0, graph, result));
+        }
+    }
+    ASSERT_EQ(
+        BfsValidationError::None,
+        validate_bfs_distances(nodes_count, 0, graph, bfs_cas_adaptive(nodes_count, 0, graph, VisitMarking::TestAndCas))
+    );
+    ASSERT_EQ(
+        BfsValidationError::None,
+        validate_bfs_distances(nodes_count, 0, graph, bfs_visited_bitset(nodes_count, 0, graph))
+    );
+    ASSERT_EQ(
+        BfsValidationError::None,
+        validate_bfs_distances(nodes_count, 0, graph, bfs_worker_buffers(nodes_count, 0, graph))
+    );
+    ASSERT_EQ(
+        BfsValidationError::None,
+        validate_bfs_tree(nodes_count, 0, graph, bfs_cas_parents(nodes_count, 0, graph))
+    );
+    std::vector<std::pair<uint64_t, uint64_t>> all_params({{15, 18}, {1, 1}, {UINT64_MAX, UINT64_MAX}});
+    for (auto [alpha, beta] : all_params)
+    {
+        pasl::pctl::parray<int64_t> result = bfs_direction_optimizing(nodes_count, 0, graph, alpha, beta);
+        ASSERT_EQ(BfsValidationError::None, validate_bfs_distances(nodes_count, 0, graph, result));
+    }
+}
+
+/*
+Bottom-up steps must search in-edges: on a directed graph the out-edges give wrong distances
+*/
+TEST(graph_generators, direction_optimizing_directed)
+{
+    adjacency_list edges = csr_to_adjacency_list(generate_rmat_graph<uint32_t>(12, 8, 42));
+    // keep one direction of every edge
+    for (uint64_t node = 0; node < edges.size(); ++node)
+    {
+        edges[node].erase(
+            std::remove_if(
+                edges[node].begin(), edges[node].end(),
+                [node](uint64_t to_node)
+                {
+                    return ((node ^ to_node) & 1) == 0 ? to_node < node : to_node > node;
+                }
+            ),
+            edges[node].end()
+        );
+    }
+    csr_graph<uint32_t> graph = adjacency_list_to_csr<uint32_t>(edges);
+    csr_graph<uint32_t> in_graph = transpose_graph(graph, csr_build_options());
+    uint64_t nodes_count = graph.nodes_count();
+    for (uint64_t start_node : {0, 1, 100})
+    {
+        std::vector<int64_t> expected = bfs_sequential(nodes_count, start_node, graph);
+        for (auto [alpha, beta] : std::vector<std::pair<uint64_t, uint64_t>>({{15, 18}, {1, 1}}))
+        {
+            pasl::pctl::parray<int64_t> result = bfs_direction_optimizing(
+                nodes_count, start_node, graph, in_graph, alpha, beta
+            );
+            ASSERT_EQ(expected, std::vector<int64_t>(result.begin(), result.end()));
+        }
+    }
+}
+
+TEST(graph_generators, permutation)
+{
+    for (uint64_t n : {1, 2, 3, 17, 64, 1000})
+    {
+        std::vector<bool> used(n, false);
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            uint64_t value = random_permutation(i, n, 42);
+            ASSERT_LT(value, n);
+            ASSERT_FALSE(used[value]);
+            used[value] = true;
+        }
+    }
+}
+
+TEST(graph_generators, rmat)
+{
+    csr_graph<uint32_t> graph = generate_rmat_graph<uint32_t>(12, 16, 42);
+    ASSERT_EQ(4096, graph.nodes_count());
+    check_undirected_graph(graph);
+    ASSERT_EQ(
+        csr_to_adjacency_list(graph),
+        csr_to_adjacency_list(generate_rmat_graph<uint32_t>(12, 16, 42))
+    );
+    ASSERT_NE(
+        csr_to_adjacency_list(graph),
+        csr_to_adjacency_list(generate_rmat_graph<uint32_t>(12, 16, 43))
+    );
+
+    uint64_t max_degree = 0;
+    for (uint64_t node = 0; node < graph.nodes_count(); ++node)
+    {
+        max_degree = std::max(max_degree, graph.degree(node));
+    }
+    ASSERT_GT(max_degree, 10 * graph.edges_count() / graph.nodes_count());
+    check_bfs_on_graph(graph);
+}
+
+TEST(graph_generators, uniform)
+{
+    csr_graph<uint64_t> graph = generate_uniform_graph<uint64_t>(5000, 8, 42);
+    ASSERT_EQ(5000, graph.nodes_count());
+    check_undirected_graph(graph);
+    ASSERT_GT(graph.edges_count(), 5000 * 8 * 9 / 10);
+    ASSERT_LE(graph.edges_count(), 5000 * 8);
+    ASSERT_EQ(
+        csr_to_adjacency_list(graph),
+        csr_to_adjacency_list(generate_uniform_graph<uint64_t>(5000, 8, 42))
+    );
+    check_bfs_on_graph(graph);
+}
+
+TEST(graph_generators, regular)
+{
+    csr_graph<uint32_t> graph = generate_regular_graph<uint32_t>(5000, 6, 42);
+    ASSERT_EQ(5000, graph.nodes_count());
+    check_undirected_graph(graph);
+    uint64_t regular_nodes = 0;
+    for (uint64_t node = 0; node < graph.nodes_count(); ++node)
+    {
+        ASSERT_LE(graph.degree(node), 6);
+        if (graph.degree(node) == 6)
+        {
+            ++regular_nodes;
+        }
+    }
+    ASSERT_GT(regular_nodes, 4900);
+    check_bfs_on_graph(graph);
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "graph_io.h"
+#include "graph_builder.h"
+#include "bfs.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+std::string write_temp_graph(std::string const& name, std::string const& contents)
+{
+    std::string path = testing::TempDir() + name;
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+    return path;
+}
+
+template <typename V>
+adjacency_list csr_to_adjacency_list(csr_graph<V> const& graph)
+{
+    adjacency_list result(graph.nodes_count());
+    for (uint64_t node = 0; node < graph.nodes_count(); ++node)
+    {
+        for (uint64_t edge_idx = 0; edge_idx < graph.degree(node); ++edge_idx)
+        {
+            result[node].push_back(graph.neighbor(node, edge_idx));
+        }
+    }
+    return result;
+}
+
+TEST(graph_io, edge_list)
+{
+    std::string path = write_temp_graph(
+        "edge_list.txt",
+        "# comment\n0 2\n\n 2\t1 7\n1 1\n0 2\n2 0\r\n3 1"
+    );
+    edge_list edges = read_edge_list(path);
+    ASSERT_EQ(4, edges.nodes_count);
+    ASSERT_EQ(6, edges.from.size());
+
+    ASSERT_EQ(
+        adjacency_list({{2, 2}, {1}, {0, 1}, {1}}),
+        csr_to_adjacency_list(load_edge_list<uint32_t>(path, csr_build_options()))
+    );
+
+    csr_build_options options;
+    options.symmetrize = true;
+    options.remove_duplicates = true;
+    options.remove_self_loops = true;
+    ASSERT_EQ(
+        adjacency_list({{2}, {2, 3}, {0, 1}, {1}}),
+        csr_to_adjacency_list(load_edge_list<uint64_t>(path, options))
+    );
+    std::remove(path.c_str());
+}
+
+TEST(graph_io, malformed_edge_list)
+{
+    std::string path = write_temp_graph("malformed.txt", "0 1\n2 x\n");
+    ASSERT_THROW(read_edge_list(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(graph_io, oversized_id)
+{
+    for (std::string id : {"18446744073709551615", "18446744073709551616", "100000000000000000000"})
+    {
+        std::string path = write_temp_graph("oversized.txt", "0 1\n" + id + " 2\n");
+        ASSERT_THROW(read_edge_list(path), std::runtime_error);
+        ASSERT_THROW(load_edge_list<uint64_t>(path, csr_build_options()), std::runtime_error);
+        std::remove(path.c_str());
+    }
+    std::string path = write_temp_graph("largest.txt", "0 18446744073709551614\n");
+    ASSERT_EQ(UINT64_MAX, read_edge_list(path).nodes_count);
+    std::remove(path.c_str());
+}
+
+TEST(graph_io, large_edge_list)
+{
+    std::default_random_engine generator(42);
+    std::uniform_int_distribution<uint64_t> node_distribution(0, 99999);
+    adjacency_list expected(100000);
+    std::string contents;
+    for (uint32_t i = 0; i < 300000; ++i)
+    {
+        uint64_t from_node = node_distribution(generator);
+        uint64_t to_node = node_distribution(generator);
+        expected[from_node].push_back(to_node);
+        contents += std::to_string(from_node) + " " + std::to_string(to_node) + "\n";
+    }
+    expected[99999].push_back(0);
+    contents += "99999 0\n";
+    for (std::vector<uint64_t>& to_nodes : expected)
+    {
+        std::sort(to_nodes.begin(), to_nodes.end());
+    }
+
+    std::string path = write_temp_graph("large_edge_list.txt", contents);
+    ASSERT_EQ(expected, csr_to_adjacency_list(load_edge_list<uint32_t>(path, csr_build_options())));
+    std::remove(path.c_str());
+}
+
+TEST(graph_io, matrix_market)
+{
+    std::string general_path = write_temp_graph(
+        "general.mtx",
+        "%%MatrixMarket matrix coordinate real general\n% comment\n3 4 3\n1 2 0.5\n3 1 1\n1 3 2e-3\n"
+    );
+    ASSERT_EQ(
+        adjacency_list({{1, 2}, {}, {0}, {}}),
+        csr_to_adjacency_list(load_matrix_market<uint32_t>(general_path, csr_build_options()))
+    );
+    std::remove(general_path.c_str());
+
+    std::string symmetric_path = write_temp_graph(
+        "symmetric.mtx",
+        "%%MatrixMarket matrix coordinate pattern symmetric\n3 3 2\n2 1\n3 2\n"
+    );
+    ASSERT_EQ(
+        adjacency_list({{1}, {0, 2}, {1}}),
+        csr_to_adjacency_list(load_matrix_market<uint32_t>(symmetric_path, csr_build_options()))
+    );
+    std::remove(symmetric_path.c_str());
+
+    std::string wrong_path = write_temp_graph(
+        "wrong.mtx",
+        "%%MatrixMarket matrix coordinate pattern general\n3 3 3\n2 1\n3 2\n"
+    );
+    ASSERT_THROW(load_matrix_market<uint32_t>(wrong_path, csr_build_options()), std::runtime_error);
+    std::remove(wrong_path.c_str());
+}
+
+TEST(graph_io, binary_csr)
+{
+    std::array<uint64_t, 3> dims = {5, 6, 7};
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    std::string path = testing::TempDir() + "graph.csr";
+    save_csr_binary(path, graph);
+
+    ASSERT_EQ(sizeof(uint32_t), csr_binary_vertex_size(path));
+    ASSERT_THROW(load_csr_binary<uint64_t>(path), std::runtime_error);
+    csr_graph<uint32_t> loaded = load_csr_binary<uint32_t>(path);
+    ASSERT_EQ(csr_to_adjacency_list(graph), csr_to_adjacency_list(loaded));
+    std::remove(path.c_str());
+}
+
+TEST(graph_io, malformed_binary_csr)
+{
+    std::string path = testing::TempDir() + "malformed.csr";
+    save_csr_binary(
+        path,
+        csr_graph<uint32_t>(pasl::pctl::parray<uint64_t>({0, 2, 1, 2}), pasl::pctl::parray<uint32_t>({0, 1}))
+    );
+    ASSERT_THROW(load_csr_binary<uint32_t>(path), std::runtime_error);
+    save_csr_binary(
+        path,
+        csr_graph<uint32_t>(pasl::pctl::parray<uint64_t>({0, 1, 2}), pasl::pctl::parray<uint32_t>({1, 2}))
+    );
+    ASSERT_THROW(load_csr_binary<uint32_t>(path), std::runtime_error);
+
+    // (nodes_count + 1) * 8 overflows to zero, so the header alone would pass an unchecked size test
+    csr_file_header header = {CSR_FILE_MAGIC, sizeof(uint32_t), (static_cast<uint64_t>(1) << 61) - 1, 0};
+    write_file(path, &header, sizeof(header));
+    ASSERT_THROW(load_csr_binary<uint32_t>(path), std::runtime_error);
+    std::remove(path.c_str());
+}
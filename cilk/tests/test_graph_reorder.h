@@ -0,0 +1,157 @@
+#pragma once
+
+#include "graph_reorder.h"
+#include "graph_generators.h"
+#include "graph_builder.h"
+#include "test_graph_io.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <numeric>
+
+template <typename V>
+void check_reordering(csr_graph<V> const& graph, VertexOrder order)
+{
+    reordered_graph<V> reordered = reorder_graph(graph, order);
+    uint64_t nodes_count = graph.nodes_count();
+    ASSERT_EQ(nodes_count, reordered.graph.nodes_count());
+    ASSERT_EQ(graph.edges_count(), reordered.graph.edges_count());
+
+    std::vector<bool> used(nodes_count, false);
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        uint64_t old_node = reordered.new_to_old[node];
+        ASSERT_LT(old_node, nodes_count);
+        ASSERT_FALSE(used[old_node]);
+        used[old_node] = true;
+        ASSERT_EQ(node, reordered.old_to_new[old_node]);
+    }
+
+    adjacency_list edges = csr_to_adjacency_list(graph);
+    adjacency_list new_edges = csr_to_adjacency_list(reordered.graph);
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        ASSERT_TRUE(std::is_sorted(new_edges[node].begin(), new_edges[node].end()));
+        std::vector<uint64_t> old_to_nodes;
+        for (uint64_t to_node : new_edges[node])
+        {
+            old_to_nodes.push_back(reordered.new_to_old[to_node]);
+        }
+        std::sort(old_to_nodes.begin(), old_to_nodes.end());
+        ASSERT_EQ(edges[reordered.new_to_old[node]], old_to_nodes);
+    }
+
+    std::vector<int64_t> dists = bfs_sequential(nodes_count, 0, graph);
+    std::vector<int64_t> new_dists = bfs_sequential(nodes_count, reordered.old_to_new[0], reordered.graph);
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        ASSERT_EQ(dists[node], new_dists[reordered.old_to_new[node]]);
+    }
+}
+
+template <typename V>
+void check_all_reorderings(csr_graph<V> const& graph)
+{
+    for (VertexOrder order : {
+        VertexOrder::Degree, VertexOrder::Bfs, VertexOrder::ReverseCuthillMcKee, VertexOrder::GorderLite})
+    {
+        check_reordering(graph, order);
+    }
+}
+
+TEST(graph_reorder, generated)
+{
+    check_all_reorderings(generate_rmat_graph<uint32_t>(10, 8, 42));
+    check_all_reorderings(generate_uniform_graph<uint64_t>(1000, 4, 42));
+}
+
+TEST(graph_reorder, cube)
+{
+    std::array<uint64_t, 3> dims = {5, 6, 7};
+    check_all_reorderings(build_csr_graph<uint32_t>(dims));
+}
+
+TEST(graph_reorder, order_by_key)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> all_sizes({{0, 1}, {1, 1}, {100000, 5}, {300000, 100000}, {50000, 1 << 20}});
+    for (auto [nodes_count, keys_count] : all_sizes)
+    {
+        pasl::pctl::parray<uint64_t> keys(
+            static_cast<long>(nodes_count),
+            [keys_count = keys_count](long node)
+            {
+                return random_permutation(static_cast<uint64_t>(node) % keys_count, keys_count, 42);
+            }
+        );
+        std::vector<uint64_t> expected(nodes_count);
+        std::iota(expected.begin(), expected.end(), 0);
+        std::stable_sort(
+            expected.begin(), expected.end(),
+            [&keys](uint64_t x, uint64_t y)
+            {
+                return keys[x] < keys[y];
+            }
+        );
+        pasl::pctl::parray<uint64_t> order = order_by_key(keys, keys_count);
+        ASSERT_EQ(expected, std::vector<uint64_t>(order.begin(), order.end()));
+    }
+}
+
+TEST(graph_reorder, degree_order)
+{
+    csr_graph<uint32_t> graph = generate_rmat_graph<uint32_t>(10, 8, 42);
+    pasl::pctl::parray<uint64_t> order = degree_order(graph);
+    for (uint64_t i = 1; i < graph.nodes_count(); ++i)
+    {
+        ASSERT_TRUE(
+            graph.degree(order[i - 1]) > graph.degree(order[i]) ||
+            (graph.degree(order[i - 1]) == graph.degree(order[i]) && order[i - 1] < order[i])
+        );
+    }
+}
+
+TEST(graph_reorder, bfs_order)
+{
+    csr_graph<uint64_t> graph = generate_uniform_graph<uint64_t>(1000, 4, 42);
+    pasl::pctl::parray<uint64_t> order = bfs_order(graph, 0);
+    std::vector<int64_t> dists = bfs_sequential(graph.nodes_count(), 0, graph);
+    ASSERT_EQ(0, order[0]);
+    for (uint64_t i = 1; i < graph.nodes_count(); ++i)
+    {
+        uint64_t prev_dist = dists[order[i - 1]] >= 0 ? dists[order[i - 1]] : graph.nodes_count();
+        uint64_t cur_dist = dists[order[i]] >= 0 ? dists[order[i]] : graph.nodes_count();
+        ASSERT_LE(prev_dist, cur_dist);
+    }
+}
+
+TEST(graph_reorder, rcm_reduces_bandwidth)
+{
+    std::array<uint64_t, 2> dims = {30, 40};
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    csr_graph<uint32_t> shuffled = relabel_graph(
+        graph,
+        pasl::pctl::parray<uint64_t>(
+            static_cast<long>(graph.nodes_count()),
+            [&graph](long node)
+            {
+                return random_permutation(node, graph.nodes_count(), 42);
+            }
+        )
+    ).graph;
+    auto bandwidth = [](csr_graph<uint32_t> const& g)
+    {
+        uint64_t result = 0;
+        for (uint64_t node = 0; node < g.nodes_count(); ++node)
+        {
+            for (uint64_t edge_idx = 0; edge_idx < g.degree(node); ++edge_idx)
+            {
+                uint64_t to_node = g.neighbor(node, edge_idx);
+                result = std::max(result, to_node > node ? to_node - node : node - to_node);
+            }
+        }
+        return result;
+    };
+    ASSERT_LE(bandwidth(reorder_graph(shuffled, VertexOrder::ReverseCuthillMcKee).graph), 2 * 30);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "graph.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include "test_graph_io.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+TEST(graph_transpose, small_graph)
+{
+    csr_graph<uint32_t> graph = adjacency_list_to_csr<uint32_t>({{1, 2, 2}, {}, {0, 1, 2}, {3, 0}});
+    ASSERT_EQ(
+        adjacency_list({{2, 3}, {0, 2}, {0, 0, 2}, {3}}),
+        csr_to_adjacency_list(transpose_graph(graph, csr_build_options()))
+    );
+
+    csr_build_options options;
+    options.remove_duplicates = true;
+    options.remove_self_loops = true;
+    ASSERT_EQ(
+        adjacency_list({{2, 3}, {0, 2}, {0}, {}}),
+        csr_to_adjacency_list(transpose_graph(graph, options))
+    );
+    ASSERT_EQ(
+        adjacency_list({{1, 2, 3}, {0, 2}, {0, 1}, {0}}),
+        csr_to_adjacency_list(symmetrize_graph(graph, options))
+    );
+    options.remove_duplicates = false;
+    ASSERT_EQ(
+        adjacency_list({{1, 2, 2, 2, 3}, {0, 2}, {0, 0, 0, 1}, {0}}),
+        csr_to_adjacency_list(symmetrize_graph(graph, options))
+    );
+}
+
+TEST(graph_transpose, empty_graph)
+{
+    csr_graph<uint32_t> graph = adjacency_list_to_csr<uint32_t>(adjacency_list());
+    ASSERT_EQ(0, transpose_graph(graph, csr_build_options()).nodes_count());
+    graph = adjacency_list_to_csr<uint32_t>(adjacency_list(5));
+    csr_graph<uint32_t> transposed = symmetrize_graph(graph, csr_build_options());
+    ASSERT_EQ(5, transposed.nodes_count());
+    ASSERT_EQ(0, transposed.edges_count());
+}
+
+TEST(graph_transpose, double_transpose)
+{
+    adjacency_list edges = csr_to_adjacency_list(generate_rmat_graph<uint32_t>(12, 8, 42));
+    // make the graph directed by dropping edges to smaller nodes in half of the lists
+    for (uint64_t node = 0; node < edges.size(); node += 2)
+    {
+        edges[node].erase(
+            std::remove_if(
+                edges[node].begin(), edges[node].end(),
+                [node](uint64_t to_node)
+                {
+                    return to_node < node;
+                }
+            ),
+            edges[node].end()
+        );
+    }
+    csr_graph<uint32_t> graph = adjacency_list_to_csr<uint32_t>(edges);
+    csr_graph<uint32_t> transposed = transpose_graph(graph, csr_build_options());
+    ASSERT_EQ(graph.edges_count(), transposed.edges_count());
+    ASSERT_EQ(edges, csr_to_adjacency_list(transpose_graph(transposed, csr_build_options())));
+}
+
+TEST(graph_transpose, symmetric_graph)
+{
+    std::array<uint64_t, 3> dims = {5, 6, 7};
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    adjacency_list edges = csr_to_adjacency_list(graph);
+    ASSERT_EQ(edges, csr_to_adjacency_list(transpose_graph(graph, csr_build_options())));
+    csr_build_options options;
+    options.remove_duplicates = true;
+    ASSERT_EQ(edges, csr_to_adjacency_list(symmetrize_graph(graph, options)));
+}
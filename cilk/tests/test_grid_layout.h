@@ -0,0 +1,107 @@
+#pragma once
+
+#include "graph_builder.h"
+#include "bfs.h"
+#include "test_csr_graph.h"
+#include "test_bfs_cube.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+template <std::size_t DIM>
+uint64_t interleave_bits(std::array<uint64_t, DIM> const& coords)
+{
+    uint64_t result = 0;
+    for (uint32_t level = 64; level >= 1; --level)
+    {
+        for (std::size_t i = 0; i < DIM; ++i)
+        {
+            result = (result << 1) | ((coords[i] >> (level - 1)) & 1);
+        }
+    }
+    return result;
+}
+
+/*
+Morton indexes are ranks of points sorted by their interleaved coordinates
+*/
+template <std::size_t DIM>
+void check_morton_layout(std::array<uint64_t, DIM> const& dims)
+{
+    std::vector<std::array<uint64_t, DIM>> points = get_all_points(dims);
+    std::sort(
+        points.begin(), points.end(),
+        [](std::array<uint64_t, DIM> const& x, std::array<uint64_t, DIM> const& y)
+        {
+            return interleave_bits(x) < interleave_bits(y);
+        }
+    );
+    grid_indexer<DIM> indexer(dims, GridLayout::Morton);
+    for (uint64_t i = 0; i < points.size(); ++i)
+    {
+        ASSERT_EQ(i, indexer.coords_to_index(points[i]));
+        ASSERT_EQ(points[i], indexer.index_to_coords(i));
+    }
+}
+
+TEST(grid_layout, morton_index)
+{
+    check_morton_layout<1>({13});
+    check_morton_layout<2>({4, 8});
+    check_morton_layout<2>({5, 3});
+    check_morton_layout<3>({4, 4, 4});
+    check_morton_layout<3>({3, 5, 7});
+    check_morton_layout<3>({1, 6, 9});
+    check_morton_layout<4>({2, 3, 4, 5});
+    check_morton_layout<2>({3, 300});
+    check_morton_layout<3>({17, 9, 33});
+}
+
+template <std::size_t DIM>
+void check_morton_graph(std::array<uint64_t, DIM> const& dims)
+{
+    pasl::pctl::parray<uint64_t> to_morton = row_major_to_layout(dims, GridLayout::Morton);
+    adjacency_list expected(calc_nodes_count(dims));
+    adjacency_list row_major_edges = build_graph(dims);
+    for (uint64_t node = 0; node < row_major_edges.size(); ++node)
+    {
+        for (uint64_t to_node : row_major_edges[node])
+        {
+            expected[to_morton[node]].push_back(to_morton[to_node]);
+        }
+    }
+    for (std::vector<uint64_t>& to_nodes : expected)
+    {
+        std::sort(to_nodes.begin(), to_nodes.end());
+    }
+    check_same_graph(expected, build_csr_graph<uint32_t>(dims, GridLayout::Morton));
+    check_same_graph(expected, grid_graph<DIM>(dims, GridLayout::Morton));
+}
+
+TEST(grid_layout, morton_graph)
+{
+    check_morton_graph<2>({8, 8});
+    check_morton_graph<2>({10, 20});
+    check_morton_graph<3>({3, 10, 5});
+}
+
+TEST(grid_layout, morton_bfs)
+{
+    std::array<uint64_t, 3> dims = {5, 6, 7};
+    grid_graph<3> graph(dims, GridLayout::Morton);
+    csr_graph<uint32_t> csr = build_csr_graph<uint32_t>(dims, GridLayout::Morton);
+    for (uint64_t start_node = 0; start_node < graph.nodes_count(); start_node += 7)
+    {
+        std::vector<int64_t> seq_result = bfs_sequential(graph.nodes_count(), start_node, graph);
+        pasl::pctl::parray<int64_t> cas_result = bfs_cas(
+            csr.nodes_count(), start_node, csr, NodeLoopType::Range, false
+        );
+        for (uint64_t node = 0; node < graph.nodes_count(); ++node)
+        {
+            ASSERT_EQ(get_dist(graph.coords(start_node), graph.coords(node)), seq_result[node]);
+            ASSERT_EQ(seq_result[node], cas_result[node]);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ms_bfs.h"
+#include "bfs.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+template <typename Graph>
+void check_multi_source_bfs(uint64_t nodes_count, std::vector<uint64_t> const& sources, Graph const& edges)
+{
+    distance_matrix result = multi_source_bfs(nodes_count, sources, edges);
+    ASSERT_EQ(sources.size(), result.sources_count());
+    ASSERT_EQ(nodes_count, result.nodes_count());
+    for (uint64_t source_idx = 0; source_idx < sources.size(); ++source_idx)
+    {
+        std::vector<int64_t> expected = bfs_sequential(nodes_count, sources[source_idx], edges);
+        for (uint64_t node = 0; node < nodes_count; ++node)
+        {
+            ASSERT_EQ(expected[node], result.get(source_idx, node));
+        }
+    }
+}
+
+TEST(ms_bfs, all_batch_widths)
+{
+    std::array<uint64_t, 3> dims = {7, 9, 10};
+    uint64_t nodes_count = calc_nodes_count(dims);
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    for (uint64_t sources_count : {1, 63, 64, 65, 200, 300, 630})
+    {
+        std::vector<uint64_t> sources;
+        for (uint64_t i = 0; i < sources_count; ++i)
+        {
+            sources.push_back((i * 37) % nodes_count);
+        }
+        check_multi_source_bfs(nodes_count, sources, graph);
+    }
+}
+
+TEST(ms_bfs, generated_graph)
+{
+    csr_graph<uint32_t> graph = generate_rmat_graph<uint32_t>(10, 4, 42);
+    std::vector<uint64_t> sources;
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        sources.push_back(random_hash(42, i) % graph.nodes_count());
+    }
+    check_multi_source_bfs(graph.nodes_count(), sources, graph);
+}
+
+TEST(ms_bfs, directed_graph)
+{
+    adjacency_list graph({{1}, {2}, {0, 3}, {}, {3}});
+    check_multi_source_bfs(graph.size(), {0, 3, 4, 2, 2}, graph);
+}
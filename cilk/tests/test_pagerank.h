@@ -0,0 +1,81 @@
+#pragma once
+
+#include "pagerank.h"
+#include "graph.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+template <typename V>
+void check_pagerank(csr_graph<V> const& graph, pagerank_options options)
+{
+    uint64_t nodes_count = graph.nodes_count();
+    csr_graph<V> in_graph = transpose_graph(graph, csr_build_options());
+    options.epsilon = 1e-12;
+    options.max_iterations = 1000;
+    pagerank_result expected = pagerank_sequential(graph, options);
+    for (bool delta_updates : {false, true})
+    {
+        options.delta_updates = delta_updates;
+        pagerank_result result = pagerank_pull(graph, in_graph, options);
+        ASSERT_LT(result.iterations, options.max_iterations);
+        for (uint64_t node = 0; node < nodes_count; ++node)
+        {
+            ASSERT_NEAR(expected.ranks[node], result.ranks[node], 1e-9);
+        }
+    }
+}
+
+TEST(pagerank, cycle)
+{
+    uint64_t nodes_count = 10;
+    adjacency_list edges(nodes_count);
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        edges[node].push_back((node + 1) % nodes_count);
+    }
+    csr_graph<uint32_t> graph = adjacency_list_to_csr<uint32_t>(edges);
+    csr_graph<uint32_t> in_graph = transpose_graph(graph, csr_build_options());
+    pagerank_options options;
+    pagerank_result result = pagerank_pull(graph, in_graph, options);
+    ASSERT_EQ(1, result.iterations);
+    options.delta_updates = true;
+    pagerank_result delta_result = pagerank_pull(graph, in_graph, options);
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        ASSERT_NEAR(0.1, result.ranks[node], 1e-12);
+        ASSERT_NEAR(0.1, delta_result.ranks[node], 1e-6);
+    }
+}
+
+TEST(pagerank, grid)
+{
+    std::array<uint64_t, 3> dims = {6, 7, 8};
+    csr_graph<uint32_t> graph = build_csr_graph<uint32_t>(dims);
+    check_pagerank(graph, pagerank_options());
+    pagerank_result result = pagerank_pull(graph, transpose_graph(graph, csr_build_options()), pagerank_options());
+    ASSERT_NEAR(1.0, sum_doubles(result.ranks), 1e-6);
+}
+
+TEST(pagerank, generated_graphs)
+{
+    pagerank_options options;
+    check_pagerank(generate_rmat_graph<uint32_t>(11, 8, 42), options);
+    check_pagerank(generate_uniform_graph<uint64_t>(3000, 3, 42), options);
+    options.damping = 0.5;
+    check_pagerank(generate_uniform_graph<uint32_t>(2000, 1, 7), options);
+}
+
+TEST(pagerank, max_iterations)
+{
+    csr_graph<uint32_t> graph = generate_rmat_graph<uint32_t>(10, 8, 42);
+    pagerank_options options;
+    options.epsilon = 0;
+    options.max_iterations = 5;
+    ASSERT_EQ(5, pagerank_pull(graph, transpose_graph(graph, csr_build_options()), options).iterations);
+    options.delta_updates = true;
+    ASSERT_EQ(5, pagerank_pull(graph, transpose_graph(graph, csr_build_options()), options).iterations);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "raw_array.h"
+#include "array_view.h"
 #include <cstdint>
+#include <string>
+#include <type_traits>
 
 struct test_struct
 {
@@ -87,3 +90,217 @@ TEST(raw_array, create_empty_array)
     ASSERT_EQ(arr.get_raw_ptr(), nullptr);
 }
 
+TEST(raw_array, fill_constructor)
+{
+    raw_array<int32_t> arr(100000, 42);
+    ASSERT_EQ(arr.size(), 100000);
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(arr[i], 42);
+    }
+}
+
+TEST(raw_array, generate_constructor)
+{
+    raw_array<int64_t> arr(100000, [](uint32_t idx) { return static_cast<int64_t>(idx) * idx; });
+    ASSERT_EQ(arr.size(), 100000);
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(arr[i], static_cast<int64_t>(i) * i);
+    }
+}
+
+TEST(raw_array, iota)
+{
+    raw_array<int32_t> arr = raw_array<int32_t>::iota(100000, -10);
+    ASSERT_EQ(arr.size(), 100000);
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(arr[i], static_cast<int32_t>(i) - 10);
+    }
+}
+
+TEST(raw_array, copying_large_array)
+{
+    raw_array<int32_t> arr = raw_array<int32_t>::iota(100000, 0);
+    raw_array<int32_t> arr_copy(arr);
+    ASSERT_NE(arr.get_raw_ptr(), arr_copy.get_raw_ptr());
+    ASSERT_EQ(arr.size(), arr_copy.size());
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(arr[i], arr_copy[i]);
+    }
+}
+
+TEST(raw_array, copy_assignment)
+{
+    raw_array<int32_t> arr = raw_array<int32_t>::iota(1000, 0);
+    raw_array<int32_t> same_size(1000, 0);
+    raw_array<int32_t> other_size(10, 0);
+    same_size = arr;
+    other_size = arr;
+    ASSERT_EQ(same_size.size(), 1000);
+    ASSERT_EQ(other_size.size(), 1000);
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(same_size[i], i);
+        ASSERT_EQ(other_size[i], i);
+    }
+}
+
+TEST(raw_array, move_assignment)
+{
+    raw_array<int32_t> arr(10, 15);
+    int32_t* ptr = arr.get_raw_ptr();
+    raw_array<int32_t> arr_moved(0);
+    arr_moved = std::move(arr);
+    ASSERT_EQ(arr_moved.get_raw_ptr(), ptr);
+    ASSERT_EQ(arr_moved.size(), 10);
+    ASSERT_EQ(arr_moved[5], 15);
+}
+
+TEST(raw_array, assign)
+{
+    raw_array<int32_t> arr(10, 1);
+    arr.assign(10, 2);
+    ASSERT_EQ(arr.size(), 10);
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(arr[i], 2);
+    }
+    arr.assign(100000, 3);
+    ASSERT_EQ(arr.size(), 100000);
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(arr[i], 3);
+    }
+    arr.assign(0, 4);
+    ASSERT_EQ(arr.size(), 0);
+    ASSERT_EQ(arr.get_raw_ptr(), nullptr);
+}
+
+TEST(raw_array, write_and_map_read_only)
+{
+    std::string path = testing::TempDir() + "raw_array_read_only.bin";
+    raw_array<int32_t> arr = raw_array<int32_t>::iota(100000, 7);
+    arr.write_to_file(path);
+
+    raw_array<int32_t const> mapped = raw_array<int32_t>::map_file<MapMode::ReadOnly>(path);
+    static_assert(std::is_const<std::remove_reference_t<decltype(mapped[0])>>::value);
+    ASSERT_TRUE(mapped.is_mapped());
+    ASSERT_EQ(arr.size(), mapped.size());
+    for (uint32_t i = 0; i < arr.size(); ++i)
+    {
+        ASSERT_EQ(arr[i], mapped[i]);
+    }
+
+    array_view<int32_t const> mapped_view(mapped);
+    ASSERT_EQ(mapped_view[500], 507);
+
+    raw_array<int32_t> mapped_copy(mapped);
+    ASSERT_FALSE(mapped_copy.is_mapped());
+    ASSERT_EQ(mapped_copy[500], 507);
+}
+
+TEST(raw_array, map_copy_on_write)
+{
+    std::string path = testing::TempDir() + "raw_array_copy_on_write.bin";
+    raw_array<int32_t> arr(1000, 1);
+    arr.write_to_file(path);
+
+    {
+        raw_array<int32_t> mapped = raw_array<int32_t>::map_file<MapMode::CopyOnWrite>(path, false, MADV_RANDOM);
+        ASSERT_EQ(arr.size(), mapped.size());
+        mapped[10] = 2;
+        ASSERT_EQ(mapped[10], 2);
+        raw_array<int32_t> mapped_moved(std::move(mapped));
+        ASSERT_TRUE(mapped_moved.is_mapped());
+        ASSERT_FALSE(mapped.is_mapped());
+        ASSERT_EQ(mapped_moved[10], 2);
+    }
+
+    raw_array<int32_t const> mapped_again = raw_array<int32_t>::map_file<MapMode::ReadOnly>(path);
+    ASSERT_EQ(mapped_again[10], 1);
+}
+
+TEST(raw_array, write_over_own_mapping)
+{
+    std::string path = testing::TempDir() + "raw_array_write_over_mapping.bin";
+    raw_array<int32_t>::iota(1 << 20, 0).write_to_file(path);
+
+    raw_array<int32_t> mapped = raw_array<int32_t>::map_file<MapMode::CopyOnWrite>(path, false);
+    mapped[10] = -1;
+    mapped.write_to_file(path);
+    ASSERT_EQ(mapped[10], -1);
+    ASSERT_EQ(mapped[1000000], 1000000);
+
+    raw_array<int32_t const> written = raw_array<int32_t>::map_file<MapMode::ReadOnly>(path);
+    ASSERT_EQ(written.size(), 1 << 20);
+    for (uint32_t i = 0; i < written.size(); ++i)
+    {
+        ASSERT_EQ(written[i], i == 10 ? -1 : static_cast<int32_t>(i));
+    }
+}
+
+TEST(raw_array, map_empty_file)
+{
+    std::string path = testing::TempDir() + "raw_array_empty.bin";
+    raw_array<int32_t> arr(0);
+    arr.write_to_file(path);
+    raw_array<int32_t const> mapped = raw_array<int32_t>::map_file<MapMode::ReadOnly>(path);
+    ASSERT_EQ(mapped.size(), 0);
+    ASSERT_EQ(mapped.get_raw_ptr(), nullptr);
+}
+
+struct counted_struct
+{
+    static int32_t alive;
+    int32_t value;
+
+    counted_struct() : value(0)
+    {
+        ++alive;
+    }
+
+    counted_struct(counted_struct const& other) : value(other.value)
+    {
+        ++alive;
+    }
+
+    counted_struct& operator=(counted_struct const& other) = default;
+
+    ~counted_struct()
+    {
+        --alive;
+    }
+};
+
+int32_t counted_struct::alive = 0;
+
+TEST(raw_array, non_trivial_elements)
+{
+    {
+        raw_array<counted_struct> arr(100);
+        ASSERT_EQ(100, counted_struct::alive);
+        arr[3].value = 5;
+        raw_array<counted_struct> arr_copy(arr);
+        ASSERT_EQ(200, counted_struct::alive);
+        ASSERT_EQ(5, arr_copy[3].value);
+        raw_array<counted_struct> arr_moved(std::move(arr_copy));
+        ASSERT_EQ(200, counted_struct::alive);
+        arr_moved.assign(10, counted_struct());
+        ASSERT_EQ(110, counted_struct::alive);
+    }
+    ASSERT_EQ(0, counted_struct::alive);
+}
+
+TEST(raw_array, strings)
+{
+    raw_array<std::string> arr(1000, std::string("value"));
+    arr[10] += "_changed";
+    raw_array<std::string> arr_copy(arr);
+    ASSERT_EQ("value_changed", arr_copy[10]);
+    ASSERT_EQ("value", arr_copy[11]);
+    raw_array<std::string> empty_strings(10);
+    ASSERT_TRUE(empty_strings[5].empty());
+}
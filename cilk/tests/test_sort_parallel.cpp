@@ -6,6 +6,8 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <string>
+#include <memory>
 
 template <template <typename, typename ...> typename C>
 void test_simple(std::function<void(C<int32_t>&)> sorter)
@@ -149,4 +151,116 @@ TEST(sort, stress_sequential)
         },
         generator
     );
-}
\ No newline at end of file
+}
+
+struct record
+{
+    int32_t key;
+    std::unique_ptr<std::vector<int32_t>> payload;
+
+    bool operator<(record const& other) const
+    {
+        return key < other.key;
+    }
+
+    bool operator>(record const& other) const
+    {
+        return key > other.key;
+    }
+
+    bool operator==(record const& other) const
+    {
+        return key == other.key;
+    }
+};
+
+void test_move_only(std::function<void(raw_array<record>&)> sorter)
+{
+    std::default_random_engine generator(time(nullptr));
+    std::uniform_int_distribution<int32_t> elements_distribution(-1000, 1000);
+    for (uint32_t i = 0; i < TESTS_COUNT / 20; ++i)
+    {
+        raw_array<record> arr(10000);
+        for (uint32_t j = 0; j < arr.size(); ++j)
+        {
+            arr[j].key = elements_distribution(generator);
+            arr[j].payload = std::make_unique<std::vector<int32_t>>(1, arr[j].key);
+        }
+
+        sorter(arr);
+
+        for (uint32_t j = 0; j < arr.size(); ++j)
+        {
+            ASSERT_TRUE(arr[j].payload != nullptr);
+            ASSERT_EQ(arr[j].key, (*arr[j].payload)[0]);
+            if (j > 0)
+            {
+                ASSERT_TRUE(arr[j - 1].key <= arr[j].key);
+            }
+        }
+    }
+}
+
+TEST(sort, parallel_move_only)
+{
+    test_move_only(
+        [](raw_array<record>& arr)
+        {
+            sort_parallel(arr, 50);
+        }
+    );
+}
+
+TEST(sort, parallel_filter_seq_move_only)
+{
+    test_move_only(
+        [](raw_array<record>& arr)
+        {
+            sort_parallel_filter_seq(arr, 50);
+        }
+    );
+}
+
+TEST(sort, parallel_no_filters_move_only)
+{
+    test_move_only(
+        [](raw_array<record>& arr)
+        {
+            sort_parallel_no_filters(arr, 50);
+        }
+    );
+}
+
+TEST(sort, sequential_move_only)
+{
+    test_move_only(
+        [](raw_array<record>& arr)
+        {
+            sort_sequential(arr);
+        }
+    );
+}
+
+TEST(sort, parallel_strings)
+{
+    std::default_random_engine generator(time(nullptr));
+    std::uniform_int_distribution<int32_t> elements_distribution(0, 1000000);
+    for (uint32_t i = 0; i < TESTS_COUNT / 20; ++i)
+    {
+        raw_array<std::string> arr(10000);
+        std::vector<std::string> v(arr.size());
+        for (uint32_t j = 0; j < arr.size(); ++j)
+        {
+            arr[j] = std::to_string(elements_distribution(generator));
+            v[j] = arr[j];
+        }
+
+        sort_parallel(arr, 50);
+        std::sort(v.begin(), v.end());
+
+        for (uint32_t j = 0; j < arr.size(); ++j)
+        {
+            ASSERT_EQ(v[j], arr[j]);
+        }
+    }
+}
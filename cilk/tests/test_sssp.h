@@ -0,0 +1,124 @@
+#pragma once
+
+#include "sssp.h"
+#include "weighted_graph.h"
+#include "bfs.h"
+#include "graph_builder.h"
+#include "graph_generators.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+template <typename V, typename W>
+void check_sssp(weighted_csr_graph<V, W> const& graph, uint64_t start_node, std::vector<int64_t> const& deltas)
+{
+    uint64_t nodes_count = graph.nodes_count();
+    std::vector<int64_t> expected = sssp_dijkstra(nodes_count, start_node, graph);
+    for (int64_t delta : deltas)
+    {
+        pasl::pctl::parray<int64_t> result = sssp_delta_stepping(nodes_count, start_node, graph, delta);
+        for (uint64_t node = 0; node < nodes_count; ++node)
+        {
+            ASSERT_EQ(expected[node], result[node]);
+        }
+    }
+}
+
+TEST(sssp, unit_weights)
+{
+    std::array<uint64_t, 3> dims = {6, 7, 8};
+    uint64_t nodes_count = calc_nodes_count(dims);
+    weighted_csr_graph<uint32_t, uint32_t> graph = build_weighted_grid_graph<uint32_t, uint32_t>(dims, 1, 42);
+    std::vector<int64_t> expected = bfs_sequential(nodes_count, 0, graph);
+    ASSERT_EQ(expected, sssp_dijkstra(nodes_count, 0, graph));
+    pasl::pctl::parray<int64_t> result = sssp_delta_stepping(nodes_count, 0, graph, 1);
+    for (uint64_t node = 0; node < nodes_count; ++node)
+    {
+        ASSERT_EQ(expected[node], result[node]);
+    }
+}
+
+TEST(sssp, weighted_grid)
+{
+    std::array<uint64_t, 2> dims = {30, 40};
+    weighted_csr_graph<uint32_t, uint32_t> graph = build_weighted_grid_graph<uint32_t, uint32_t>(dims, 100, 42);
+    for (uint64_t start_node : {0, 555, 1199})
+    {
+        check_sssp(graph, start_node, {1, 7, 50, 100, 1000000});
+    }
+}
+
+TEST(sssp, generated_graphs)
+{
+    weighted_csr_graph<uint32_t, uint32_t> rmat = add_random_weights(
+        generate_rmat_graph<uint32_t>(11, 8, 42), static_cast<uint32_t>(1000), 7
+    );
+    check_sssp(rmat, 0, {1, 100, 500, 1000});
+    weighted_csr_graph<uint64_t, uint8_t> uniform = add_random_weights(
+        generate_uniform_graph<uint64_t>(3000, 3, 42), static_cast<uint8_t>(255), 7
+    );
+    check_sssp(uniform, 17, {1, 32, 255});
+    // a ring of max_weight / delta buckets would not fit into memory
+    weighted_csr_graph<uint32_t, uint32_t> heavy = add_random_weights(
+        generate_uniform_graph<uint32_t>(2000, 4, 42), static_cast<uint32_t>(1) << 31, 7
+    );
+    check_sssp(heavy, 0, {1, 1000});
+}
+
+TEST(sssp, symmetric_weights)
+{
+    weighted_csr_graph<uint32_t, uint32_t> graph = add_random_weights(
+        generate_uniform_graph<uint32_t>(500, 8, 42), static_cast<uint32_t>(1000), 7
+    );
+    for (uint64_t from_node = 0; from_node < graph.nodes_count(); ++from_node)
+    {
+        for (uint64_t edge_idx = 0; edge_idx < graph.degree(from_node); ++edge_idx)
+        {
+            uint64_t to_node = graph.neighbor(from_node, edge_idx);
+            auto const& to_edges = graph.get_graph().get_edges();
+            auto to_begin = to_edges.begin() + graph.get_graph().get_offsets()[to_node];
+            uint64_t back_idx = std::lower_bound(to_begin, to_begin + graph.degree(to_node), from_node) - to_begin;
+            ASSERT_EQ(graph.weight(from_node, edge_idx), graph.weight(to_node, back_idx));
+        }
+    }
+}
+
+TEST(sssp, buckets)
+{
+    delta_stepping_buckets buckets(3, 2);
+    ASSERT_EQ(UINT64_MAX, buckets.next_bucket(0));
+    buckets.add(5, 1);
+    buckets.add(7, 2);
+    buckets.add(5, 1);
+    ASSERT_EQ(1, buckets.next_bucket(0));
+    pasl::pctl::parray<int64_t> nodes = buckets.take(1);
+    ASSERT_EQ(2, nodes.size());
+    ASSERT_EQ(5, nodes[0]);
+    ASSERT_EQ(5, nodes[1]);
+    ASSERT_EQ(0, buckets.take(1).size());
+    // bucket 3 shares the slot with bucket 0
+    buckets.add(9, 3);
+    ASSERT_EQ(2, buckets.next_bucket(2));
+    ASSERT_EQ(1, buckets.take(2).size());
+    ASSERT_EQ(3, buckets.next_bucket(3));
+    ASSERT_EQ(9, buckets.take(3)[0]);
+    ASSERT_EQ(UINT64_MAX, buckets.next_bucket(4));
+    // buckets beyond the ring wait in the overflow, until the ring is empty
+    buckets.add(11, 4);
+    buckets.add(12, 100);
+    buckets.add(13, 101);
+    buckets.add(14, 200);
+    ASSERT_EQ(4, buckets.next_bucket(4));
+    ASSERT_EQ(11, buckets.take(4)[0]);
+    ASSERT_EQ(100, buckets.next_bucket(5));
+    ASSERT_EQ(12, buckets.take(100)[0]);
+    buckets.add(15, 102);
+    ASSERT_EQ(101, buckets.next_bucket(101));
+    ASSERT_EQ(13, buckets.take(101)[0]);
+    ASSERT_EQ(102, buckets.next_bucket(102));
+    ASSERT_EQ(15, buckets.take(102)[0]);
+    ASSERT_EQ(200, buckets.next_bucket(103));
+    ASSERT_EQ(14, buckets.take(200)[0]);
+    ASSERT_EQ(UINT64_MAX, buckets.next_bucket(201));
+}